@@ -4,6 +4,7 @@
 #include <array>
 #include <limits>
 #include <cmath>
+#include <thread>
 
 //TODO: Constrain points within the image
 namespace img
@@ -16,17 +17,21 @@ struct Rectangle
 
     Rectangle() = default;
     Rectangle(util::RNG& rng)
-    : x1(rng.integer(0, std::numeric_limits<uint16_t>::max()))
-    , x2(rng.integer(0, std::numeric_limits<uint16_t>::max()))
-    , y1(rng.integer(0, std::numeric_limits<uint16_t>::max()))
-    , y2(rng.integer(0, std::numeric_limits<uint16_t>::max()))
-    , color({
-        static_cast<uint8_t>(rng.integer(0, std::numeric_limits<uint8_t>::max())),
-        static_cast<uint8_t>(rng.integer(0, std::numeric_limits<uint8_t>::max())),
-        static_cast<uint8_t>(rng.integer(0, std::numeric_limits<uint8_t>::max())),
-        static_cast<uint8_t>(rng.integer(64, std::numeric_limits<uint8_t>::max()))
-    })
-    { }
+    {
+        // Coordinates and colour channels cover their whole range, so each is a slice of random bits
+        uint64_t bits[2];
+        rng.fillBits(bits);
+        x1 = static_cast<uint16_t>(bits[0]);
+        x2 = static_cast<uint16_t>(bits[0] >> 16);
+        y1 = static_cast<uint16_t>(bits[0] >> 32);
+        y2 = static_cast<uint16_t>(bits[0] >> 48);
+        color = {
+            static_cast<uint8_t>(bits[1]),
+            static_cast<uint8_t>(bits[1] >> 8),
+            static_cast<uint8_t>(bits[1] >> 16),
+            static_cast<uint8_t>(rng.integer(64, std::numeric_limits<uint8_t>::max()))
+        };
+    }
 };
 constexpr unsigned int NUM_RECTS = 16;
 using Approximation = std::array<Rectangle, NUM_RECTS>;
@@ -149,8 +154,11 @@ class Scenario : public genetic::Scenario<Approximation>
     {
         static const std::size_t NUM_PIXELS = renderer_.getImage().getSize().x * renderer_.getImage().getSize().y * 4;
         
+        // Render targets cannot be shared between threads, so each evaluating thread gets its own
+        thread_local Renderer renderer (renderer_.getImage());
+
         int sum = 0;
-        sf::Image render = renderer_.renderApproximation(approx).copyToImage();
+        sf::Image render = renderer.renderApproximation(approx).copyToImage();
         for (int i = 0; i < NUM_PIXELS; i += 4 * PIXEL_STRIDE)
         {
             for (int c = 0; c < 3; ++c) // R, G, & B only
@@ -251,14 +259,17 @@ class View : public genetic::GraphicView<Approximation>
 
 int main()
 {
+    genetic::GeneticAlgorithm<img::Approximation> ga (
+        std::make_unique<img::Scenario>(img::monalisa),
+        genetic::selection::tournament<img::Approximation, 5>,
+        200, // Population Size
+        .05f // Elitism Rate
+    );
+    ga.setThreads(std::max(1u, std::thread::hardware_concurrency()));
+
     auto cli = genetic::Controller<img::Approximation>
     (
-        genetic::GeneticAlgorithm<img::Approximation>(
-            std::make_unique<img::Scenario>(img::monalisa),
-            genetic::selection::tournament<img::Approximation, 5>,
-            200, // Population Size
-            .05f // Elitism Rate
-        ),
+        std::move(ga),
         std::make_unique<img::View>()
     );
     cli.run();
@@ -33,6 +33,12 @@ class FunctionOptimizationScenario : public Scenario<float>
     {
         return rastrigin1D(n);
     }
+    void evaluateFitnessBatch(std::span<const float> xs, std::span<float> fitness)
+    {
+        // Straight-line loop over contiguous arrays, vectorizable by the compiler
+        for (std::size_t i = 0; i < xs.size(); ++i)
+            fitness[i] = rastrigin1D(xs[i]);
+    }
     float birth(util::RNG& rng)
     {
         return rng.real(-2.f, 2.f);
@@ -65,11 +71,17 @@ class NumberView : public genetic::View<float>
 
 int main()
 {
-    auto cli = genetic::Controller<float>
+    // The scenario and selection are fixed at compile time, so the breeding loop is inlined
+    using Engine = genetic::StaticGeneticAlgorithm<
+        FunctionOptimizationScenario,
+        genetic::selection::Static<genetic::selection::rankBased<float>>
+    >;
+
+    auto cli = genetic::Controller<float, Engine>
     (
-        genetic::GeneticAlgorithm<float>(
-            std::make_unique<FunctionOptimizationScenario>(),
-            genetic::selection::rankBased<float>,
+        Engine(
+            FunctionOptimizationScenario(),
+            {},
             10,
             .1f
         ),
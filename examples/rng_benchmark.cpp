@@ -0,0 +1,98 @@
+#include "utils/rng.h"
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <span>
+
+// The previous util::RNG: a 32-bit Mersenne Twister with a standard
+// distribution constructed on every call
+class StandardRNG
+{
+    private:
+    std::mt19937 gen_;
+
+    public:
+    StandardRNG(int seed)
+    : gen_(seed)
+    { }
+
+    long int integer(long int low, long int high)
+    {
+        std::uniform_int_distribution<long int> dist(low, high);
+        return dist(gen_);
+    }
+    std::size_t index(std::size_t size)
+    {
+        std::uniform_int_distribution<std::size_t> dist(0, size - 1);
+        return dist(gen_);
+    }
+    float real(float low, float high)
+    {
+        std::uniform_real_distribution<> dist(low, high);
+        return dist(gen_);
+    }
+};
+
+constexpr std::size_t DRAWS = 50'000'000;
+
+// Runs one kind of draw DRAWS times, folding the results into a checksum so
+// that the compiler cannot drop the loop
+template <typename R, typename Draw>
+void measure(const char* generator, const char* draw_name, Draw draw)
+{
+    R rng (42);
+    double checksum = 0.0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < DRAWS; ++i)
+        checksum += draw(rng);
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    std::printf("%-12s %-14s %6.2f ns/draw  (checksum %g)\n",
+        generator, draw_name, elapsed.count() * 1e9 / DRAWS, checksum);
+}
+
+// Draws DRAWS values through a bulk fill of `BUFFER` values at a time
+template <typename R, typename V, typename Fill>
+void measureBulk(const char* generator, const char* draw_name, Fill fill)
+{
+    constexpr std::size_t BUFFER = 1024;
+    R rng (42);
+    V values[BUFFER];
+    double checksum = 0.0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < DRAWS; i += BUFFER)
+    {
+        fill(rng, std::span<V>(values));
+        checksum += values[i % BUFFER];
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    std::printf("%-12s %-14s %6.2f ns/draw  (checksum %g)\n",
+        generator, draw_name, elapsed.count() * 1e9 / DRAWS, checksum);
+}
+
+template <typename R>
+void measureAll(const char* generator)
+{
+    // integer(0, 100) is BinaryEncoding's per-bit mutation roll
+    measure<R>(generator, "integer(0,100)", [](R& rng) { return rng.integer(0, 100); });
+    measure<R>(generator, "index(1000)", [](R& rng) { return rng.index(1000); });
+    measure<R>(generator, "real(0,1)", [](R& rng) { return rng.real(0.f, 1.f); });
+
+    if constexpr (requires (R& rng, std::span<uint64_t> words) { rng.fillBits(words); })
+    {
+        measureBulk<R, uint64_t>(generator, "fillBits", [](R& rng, std::span<uint64_t> v) { rng.fillBits(v); });
+        measureBulk<R, long int>(generator, "fillIntegers", [](R& rng, std::span<long int> v) { rng.fillIntegers(v, 0, 100); });
+        measureBulk<R, float>(generator, "fillReals", [](R& rng, std::span<float> v) { rng.fillReals(v, 0.f, 1.f); });
+    }
+}
+
+int main()
+{
+    measureAll<StandardRNG>("mt19937+std");
+    measureAll<util::MersenneRNG>("mt19937_64");
+    measureAll<util::FastRNG>("xoshiro256++");
+    measureAll<util::RNG>("philox4x32");
+}
@@ -4,6 +4,7 @@
 #include <array>
 #include <algorithm>
 #include <utility>
+#include <thread>
 
 namespace tsp 
 {
@@ -90,23 +91,92 @@ namespace tsp
 
             return -total_distance;
         }
+        void evaluateFitnessBatch(std::span<const Path> paths, std::span<float> fitness)
+        {
+            // Walk a block of tours in lockstep so that the inner loop runs across tours
+            // rather than along one, letting the compiler vectorize the weight gathers
+            constexpr std::size_t BLOCK = 16;
+            for (std::size_t begin = 0; begin < paths.size(); begin += BLOCK)
+            {
+                const std::size_t count = std::min(BLOCK, paths.size() - begin);
+                std::array<float, BLOCK> total_distance {};
+                std::array<int, BLOCK> prev {};
+
+                for (std::size_t k = 0; k < NUM_CITIES - 1; ++k)
+                {
+                    for (std::size_t j = 0; j < count; ++j)
+                    {
+                        int curr = paths[begin + j][k];
+                        total_distance[j] += Graph::instance.weight(prev[j], curr);
+                        prev[j] = curr;
+                    }
+                }
+
+                for (std::size_t j = 0; j < count; ++j)
+                {
+                    total_distance[j] += Graph::instance.weight(prev[j], 0);
+                    fitness[begin + j] = -total_distance[j];
+                }
+            }
+        }
 
         Path birth(util::RNG& rng)
         {
             Path path;
             for (int i = 0; i < path.size(); ++i)
                 path[i] = i + 1;
-            std::shuffle(path.begin(), path.end(), rng.generator());
+            rng.shuffle(std::span<int>(path));
             return std::move(path);
         }
 
         void mutate(Path& path, util::RNG& rng)
+        {
+            genetic::MutationRecord record;
+            mutateRecorded(path, rng, record);
+        }
+
+        bool mutateRecorded(Path& path, util::RNG& rng, genetic::MutationRecord& record)
         {
             int i = rng.integer(0, path.size() - 2);
             int j = rng.integer(i + 1, path.size() - 1);
             int temp = path[i];
             path[i] = path[j];
             path[j] = temp;
+
+            record.positions[0] = i;
+            record.positions[1] = j;
+            record.count = 2;
+            return true;
+        }
+
+        float evaluateFitnessDelta(const Path& path, float parent_fitness, const genetic::MutationRecord& record)
+        {
+            // Only the (at most four) edges touching the two swapped cities change
+            const int i = record.positions[0];
+            const int j = record.positions[1];
+            auto city = [&](int k, bool parent)
+            {
+                if (k < 0 || k >= static_cast<int>(path.size()))
+                    return 0;
+                if (parent && k == i)
+                    return path[j];
+                if (parent && k == j)
+                    return path[i];
+                return path[k];
+            };
+
+            const std::array<int, 4> edges {i - 1, i, j - 1, j};
+            float delta = 0.f;
+            for (std::size_t e = 0; e < edges.size(); ++e)
+            {
+                if (std::find(edges.begin(), edges.begin() + e, edges[e]) != edges.begin() + e)
+                    continue;
+
+                delta += Graph::instance.weight(city(edges[e], true), city(edges[e] + 1, true))
+                    - Graph::instance.weight(city(edges[e], false), city(edges[e] + 1, false));
+            }
+
+            return parent_fitness + delta;
         }
 
         Path crossover(const Path& a, const Path& b, util::RNG& rng)
@@ -221,14 +291,19 @@ int main()
 {
     tsp::Graph::instance.init(0);
 
+    genetic::GeneticAlgorithm<tsp::Path> ga (
+        std::make_unique<tsp::Scenario>(),
+        genetic::selection::rankBased<tsp::Path>,
+        1000,
+        .01f
+    );
+    ga.setThreads(std::max(1u, std::thread::hardware_concurrency()));
+    ga.setCrossoverRate(.5f);
+    ga.setFitnessCache(4096, genetic::CachePolicy::Clock);
+
     auto cli = genetic::Controller<tsp::Path>
     (
-        genetic::GeneticAlgorithm<tsp::Path>(
-            std::make_unique<tsp::Scenario>(),
-            genetic::selection::rankBased<tsp::Path>,
-            1000,
-            .01f
-        ),
+        std::move(ga),
         std::make_unique<tsp::View>()
     );
     cli.run();
@@ -16,25 +16,27 @@ namespace genetic
 template <typename T>
 using ViewCallback = std::function<void(const std::vector<Member<T>>&, ViewType)>;
 
-template <typename T>
+// Engine is anything exposing GeneticAlgorithm's evolution, population and save interface
+template <typename T, typename Engine = GeneticAlgorithm<T>>
 class Controller
 {
     private:
         using EvolutionCondition = std::function<bool(const PopulationHistory<T>& pop, float time)>;
 
-        GeneticAlgorithm<T> ga_;
+        Engine ga_;
         util::CommandHandler command_handler_;
         std::unique_ptr<View<T>> view_;
         bool running_;
     
     public:
         // Lifecycle
-        Controller(GeneticAlgorithm<T>&& ga, std::unique_ptr<View<T>> view);
+        Controller(Engine&& ga, std::unique_ptr<View<T>> view);
         void run();
         void stop();
 
         // Save management
         void restart();
+        void restartFrom(const std::string& id);
         void save();
         void load(const std::string& id);
         void listSaves();
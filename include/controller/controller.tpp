@@ -3,13 +3,14 @@
 #include <sstream>
 #include <cctype>
 #include <chrono>
+#include <cmath>
 #include <thread>
 
 namespace genetic 
 {
 
-template<typename T>
-Controller<T>::Controller(GeneticAlgorithm<T>&& ga, std::unique_ptr<View<T>> view)
+template <typename T, typename Engine>
+Controller<T, Engine>::Controller(Engine&& ga, std::unique_ptr<View<T>> view)
     : ga_(std::move(ga))
     , view_(std::move(view))
     , running_(false)
@@ -17,6 +18,7 @@ Controller<T>::Controller(GeneticAlgorithm<T>&& ga, std::unique_ptr<View<T>> vie
     command_handler_.bind<&Controller::stop>("quit", *this);
     command_handler_.bind<&Controller::stop>("exit", *this);
     command_handler_.bind<&Controller::restart>("restart", *this);
+    command_handler_.bind<&Controller::restartFrom>("restart-from", *this);
     command_handler_.bind<&Controller::save>("save", *this);
     command_handler_.bind<&Controller::load>("load", *this);
     command_handler_.bind<&Controller::deleteSave>("delete-save", *this);
@@ -33,8 +35,8 @@ Controller<T>::Controller(GeneticAlgorithm<T>&& ga, std::unique_ptr<View<T>> vie
     command_handler_.bind<&Controller::evolveUntilStagnant>("evolve-until-stagnant", *this);
 }
 
-template<typename T>
-void Controller<T>::run()
+template <typename T, typename Engine>
+void Controller<T, Engine>::run()
 {
     std::string input;
     running_ = true;
@@ -53,26 +55,47 @@ void Controller<T>::run()
     }
 }
 
-template<typename T>
-void Controller<T>::stop()
+template <typename T, typename Engine>
+void Controller<T, Engine>::stop()
 {
     running_ = false;
 }
 
-template<typename T>
-void Controller<T>::restart()
+template <typename T, typename Engine>
+void Controller<T, Engine>::restart()
 {
     ga_.restart();
 }
 
-template<typename T>
-void Controller<T>::save()
+template <typename T, typename Engine>
+void Controller<T, Engine>::restartFrom(const std::string& id)
+{
+    // Population ids double as seeds, so this replays the population with that id
+    std::size_t parsed = 0;
+    unsigned long value = 0;
+    try
+    {
+        value = std::stoul(id, &parsed, 16);
+    }
+    catch (const std::exception&)
+    {
+        parsed = 0;
+    }
+
+    if (parsed != id.size() || value > UINT32_MAX)
+        throw std::invalid_argument("Invalid population id \"" + id + "\"");
+
+    ga_.restart(static_cast<uint32_t>(value));
+}
+
+template <typename T, typename Engine>
+void Controller<T, Engine>::save()
 {
     ga_.savePopulation();
 }
 
-template<typename T>
-void Controller<T>::load(const std::string& id)
+template <typename T, typename Engine>
+void Controller<T, Engine>::load(const std::string& id)
 {
     if (ga_.loadPopulation(id))
     {
@@ -84,20 +107,20 @@ void Controller<T>::load(const std::string& id)
     }
 }
 
-template<typename T>
-void Controller<T>::deleteSave(const std::string& id)
+template <typename T, typename Engine>
+void Controller<T, Engine>::deleteSave(const std::string& id)
 {
     ga_.deleteSave(id);
 }
 
-template<typename T>
-void Controller<T>::deleteAllSaves()
+template <typename T, typename Engine>
+void Controller<T, Engine>::deleteAllSaves()
 {
     ga_.deleteAllSaves();
 }
 
-template<typename T>
-void Controller<T>::listSaves()
+template <typename T, typename Engine>
+void Controller<T, Engine>::listSaves()
 {
     std::vector<std::string> saves = ga_.getSaves();
 
@@ -107,42 +130,82 @@ void Controller<T>::listSaves()
     }
 }
 
-template<typename T>
-void Controller<T>::printStats()
+template <typename T, typename Engine>
+void Controller<T, Engine>::printStats()
 {
     const auto& pop = ga_.getPopulation();
+    const GenerationStats& stats = pop.current().stats();
     std::cout   << "Generation:     " << pop.numGenerations() << "\n"
                 << "Fittest Score:  " << pop.currentFittestScore() << "\n"
-                << "Population ID:  " << pop.formattedId() << "\n";
+                << "Mean Score:     " << stats.mean << " (std. dev. " << std::sqrt(stats.variance) << ")\n"
+                << "Quartiles:      " << stats.lower_quartile << " / " << stats.median << " / " << stats.upper_quartile << "\n"
+                << "Lowest Score:   " << stats.lowest_score << "\n"
+                << "Population ID:  " << pop.formattedId() << "\n"
+                << "History Memory: " << pop.memoryUsage() / 1024 << " KiB ("
+                << pop.retainedGenerations().size() << " of " << pop.numGenerations() << " generations retained)\n";
+
+    if (const auto* store = pop.spillStore())
+    {
+        std::cout   << "Spilled:        " << store->numStored() << " generations, "
+                    << store->fileSize() / (1024 * 1024) << " MiB in " << store->path() << "\n";
+    }
+
+    if constexpr (requires { ga_.getFitnessCache(); })
+    {
+        if (const auto* cache = ga_.getFitnessCache())
+        {
+            std::cout   << "Cache Hits:     " << cache->hits() << "\n"
+                        << "Cache Misses:   " << cache->misses() << "\n"
+                        << "Cache Size:     " << cache->size() << "/" << cache->capacity() << "\n";
+        }
+    }
 }
 
-template <typename T>
-void Controller<T>::viewGeneration(std::size_t i)
+template <typename T, typename Engine>
+void Controller<T, Engine>::viewGeneration(std::size_t i)
 {
-    if (i < ga_.getPopulation().numGenerations())
+    if (i >= ga_.getPopulation().numGenerations())
     {
-        view_->create(ga_.getPopulation().generation(i).members(), ViewType::Population);
+        std::cerr << "Input generation does not exist\n";
+    }
+    else if constexpr (requires { ga_.generation(i); })
+    {
+        // The engine breeds generations that were not retained again where it can
+        if (!ga_.getPopulation().isRetained(i) && !ga_.getPopulation().isReplayable(i))
+            std::cerr << "Generation " << i << " was not retained\n";
+        else
+            view_->create(ga_.generation(i).members(), ViewType::Population);
+    }
+    else if (!ga_.getPopulation().isRetained(i))
+    {
+        std::cerr << "Generation " << i << " was not retained\n";
     }
     else
     {
-        std::cerr << "Input generation does not exist\n";
+        view_->create(ga_.getPopulation().generation(i).members(), ViewType::Population);
     }
 }
 
-template <typename T>
-void Controller<T>::viewCurrent()
+template <typename T, typename Engine>
+void Controller<T, Engine>::viewCurrent()
 {
     view_->create(ga_.getPopulation().current().members(), ViewType::Population);
 }
 
-template <typename T>
-void Controller<T>::viewBest()
+template <typename T, typename Engine>
+void Controller<T, Engine>::viewBest()
 {
-    view_->create(ga_.getPopulation().fittestHistory(), ViewType::Generations);
+    std::vector<Member<T>> history = ga_.getPopulation().fittestHistory();
+    if (history.empty())
+    {
+        std::cerr << "The fittest member of each generation was not retained\n";
+        return;
+    }
+    view_->create(history, ViewType::Generations);
 }
 
-template <typename T>
-void Controller<T>::evolve(EvolutionCondition condition)
+template <typename T, typename Engine>
+void Controller<T, Engine>::evolve(EvolutionCondition condition)
 {
     auto start_time = std::chrono::high_resolution_clock::now();
     float time_elapsed = 0.f;
@@ -166,14 +229,14 @@ void Controller<T>::evolve(EvolutionCondition condition)
     std::cout << "\n\n\n";
 }
 
-template <typename T>
-void Controller<T>::evolveGenerations(int generations)
+template <typename T, typename Engine>
+void Controller<T, Engine>::evolveGenerations(int generations)
 {
     evolveUntilGeneration(ga_.getPopulation().numGenerations() + generations);
 }
 
-template <typename T>
-void Controller<T>::evolveSeconds(float seconds)
+template <typename T, typename Engine>
+void Controller<T, Engine>::evolveSeconds(float seconds)
 {
     EvolutionCondition cond = [seconds](const PopulationHistory<T>&, float time)
     {
@@ -183,8 +246,8 @@ void Controller<T>::evolveSeconds(float seconds)
     evolve(cond);
 }
 
-template <typename T>
-void Controller<T>::evolveUntilGeneration(int target_generation)
+template <typename T, typename Engine>
+void Controller<T, Engine>::evolveUntilGeneration(int target_generation)
 {
     EvolutionCondition cond = [target_generation](const PopulationHistory<T>& pop, float)
     {
@@ -194,8 +257,8 @@ void Controller<T>::evolveUntilGeneration(int target_generation)
     evolve(cond);
 }
 
-template <typename T>
-void Controller<T>::evolveUntilFitness(float target_fitness)
+template <typename T, typename Engine>
+void Controller<T, Engine>::evolveUntilFitness(float target_fitness)
 {
     constexpr std::size_t TIMEOUT = 10000;
     int start = ga_.getPopulation().numGenerations();
@@ -207,8 +270,8 @@ void Controller<T>::evolveUntilFitness(float target_fitness)
     evolve(cond);
 }
 
-template <typename T>
-void Controller<T>::evolveUntilStagnant(int generations, float minimum_average_improvement)
+template <typename T, typename Engine>
+void Controller<T, Engine>::evolveUntilStagnant(int generations, float minimum_average_improvement)
 {
     EvolutionCondition cond =
         [generations, minimum_average_improvement]
@@ -218,7 +281,7 @@ void Controller<T>::evolveUntilStagnant(int generations, float minimum_average_i
                 return true;
 
             float current_fittest = pop.currentFittestScore();
-            float fittest_x_generations_ago = pop.fittestHistory()[pop.numGenerations() - generations].fitness;
+            float fittest_x_generations_ago = pop.stats()[pop.numGenerations() - generations].fittest_score;
             
             float improvement = (current_fittest / fittest_x_generations_ago) - 1.f;
             float avg_improvement = improvement / static_cast<float>(generations);
@@ -0,0 +1,117 @@
+#ifndef ASYNC_GA_H
+#define ASYNC_GA_H
+
+#include "scenario.h"
+#include "member.h"
+#include "generation.h"
+#include "population_history.h"
+#include "operator/selection.h"
+#include "serialization/serializer.h"
+#include "utils/rng.h"
+#include "utils/work_stealing_pool.h"
+
+#include <condition_variable>
+#include <exception>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace genetic
+{
+
+// Master-worker genetic algorithm without generational barriers. Workers
+// evaluate children on a work-stealing pool, and as soon as a child's fitness
+// is known the master inserts it in place of the least fit member and breeds
+// another. Each evolve() call inserts one population's worth of children and
+// records a snapshot, so the Controller's stop conditions apply unchanged.
+// Every child is bred from its own RNG stream, keyed by its sequence number,
+// but which members it is bred from depends on which children finished first,
+// unless setReproducible() is on. The scenario's evaluateFitness must be safe
+// to call from several threads while the master breeds.
+template <typename T>
+class AsyncGeneticAlgorithm
+{
+    private:
+        // Shared with the workers, so it stays put when the algorithm is moved
+        struct Completions
+        {
+            std::mutex mutex;
+            std::condition_variable ready;
+            std::vector<std::pair<uint64_t, Member<T>>> members; // Tagged with sequence numbers
+            std::exception_ptr error;
+        };
+
+        std::unique_ptr<Scenario<T>> scenario_;
+
+        selection::Function<T> selection_function_;
+
+        PopulationHistory<T> population_;
+
+        util::RNG rng_;
+
+        std::optional<Generation<T>> working_;
+
+        std::unique_ptr<Completions> completions_;
+        std::size_t in_flight_;
+        std::size_t max_in_flight_;
+        bool reproducible_;
+        std::size_t batch_size_;
+
+        // Children are numbered from 0 at each restart, births first
+        uint64_t next_sequence_;
+        uint64_t next_insert_;
+        std::vector<std::optional<Member<T>>> arrived_; // Finished but not yet inserted, by sequence % max_in_flight_
+
+        // Declared last so that it finishes outstanding tasks before the state they use is destroyed
+        std::unique_ptr<util::WorkStealingPool> pool_;
+
+        void submit(T&& genome);
+        std::vector<std::pair<uint64_t, Member<T>>> awaitCompletions();
+        void drain();
+        void fill();
+
+    public:
+        AsyncGeneticAlgorithm(
+            std::unique_ptr<Scenario<T>> scenario,
+            selection::Function<T> select,
+            std::size_t population_size,
+            std::size_t num_workers
+        );
+
+        void restart();
+        void restart(uint32_t id);
+        void evolve();
+
+        // Off by default. When on, children are inserted in batches of half the
+        // children in flight, in the order they were bred, and new children are
+        // bred only between batches, so a seed and a number of workers give the
+        // same run however the workers are scheduled. The cost is throughput: a
+        // batch waits for its slowest child, and once the next batch is done its
+        // workers sit idle until then. Discards the children in flight.
+        void setReproducible(bool reproducible);
+
+        // Any retention but Retention::Replay, since children inserted into a
+        // generation were bred from earlier ones
+        void setRetention(Retention retention, std::size_t n = 1);
+        void spillTo(const std::filesystem::path& path);
+
+        const std::string& getProblem() const;
+        const PopulationHistory<T>& getPopulation() const;
+
+        // Expose serializer functionality
+        const Serializer<T>& getSerializer();
+        bool savePopulation();
+        bool loadPopulation(std::string id);
+        std::vector<std::string> getSaves() const;
+        bool deleteSave(const std::string& id) const;
+        bool deleteAllSaves() const;
+};
+
+}
+
+#include "async_ga.tpp"
+#endif
@@ -0,0 +1,295 @@
+#include "async_ga.h"
+#include <algorithm>
+#include <stdexcept>
+#include <array>
+
+namespace genetic
+{
+
+template <typename T>
+AsyncGeneticAlgorithm<T>::AsyncGeneticAlgorithm(
+    std::unique_ptr<Scenario<T>> scenario,
+    selection::Function<T> select,
+    std::size_t population_size,
+    std::size_t num_workers
+)
+    : scenario_(std::move(scenario))
+    , selection_function_(select)
+    , population_(0, population_size)
+    , rng_()
+    , completions_(std::make_unique<Completions>())
+    , in_flight_(0)
+    , max_in_flight_(std::min(2 * std::max<std::size_t>(num_workers, 1), population_size))
+    , reproducible_(false)
+    , batch_size_(std::max<std::size_t>(max_in_flight_ / 2, 1))
+    , next_sequence_(0)
+    , next_insert_(0)
+    , arrived_(max_in_flight_)
+    , pool_(std::make_unique<util::WorkStealingPool>(num_workers))
+{
+    restart();
+}
+
+template <typename T>
+void AsyncGeneticAlgorithm<T>::restart()
+{
+    restart(rng_.index(UINT32_MAX));
+}
+
+template <typename T>
+void AsyncGeneticAlgorithm<T>::restart(uint32_t id)
+{
+    drain();
+
+    std::size_t size = population_.populationSize();
+    population_.restart(id, size);
+    working_.reset();
+    next_sequence_ = 0;
+
+    // Birth
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        util::RNG rng (id, next_sequence_);
+        submit(scenario_->birth(rng));
+    }
+
+    std::vector<Member<T>> next (size);
+    while (in_flight_ > 0)
+    {
+        for (auto& [sequence, member] : awaitCompletions())
+            next[sequence] = std::move(member);
+    }
+    next_insert_ = size;
+
+    population_.pushNext(std::move(next));
+}
+
+template <typename T>
+void AsyncGeneticAlgorithm<T>::evolve()
+{
+    if (!working_)
+        working_.emplace(population_.current());
+
+    fill();
+
+    const uint64_t end = next_insert_ + population_.populationSize();
+    std::vector<Member<T>> children;
+    if (!reproducible_)
+    {
+        while (next_insert_ < end)
+        {
+            children.clear();
+            for (auto& [sequence, member] : awaitCompletions())
+                children.push_back(std::move(member));
+            next_insert_ += children.size();
+            working_->replaceWorst(children);
+
+            // Keeps the workers busy, including while the caller looks at the snapshot
+            fill();
+        }
+    }
+    else
+    {
+        // Children are inserted in batches of consecutive sequence numbers and bred
+        // only between batches, so what each is bred from does not depend on timing.
+        // Later children keep the workers busy while a batch waits for its slowest.
+        while (next_insert_ < end)
+        {
+            const std::size_t batch = std::min<uint64_t>(batch_size_, end - next_insert_);
+            children.clear();
+            while (children.size() < batch)
+            {
+                std::optional<Member<T>>& slot = arrived_[(next_insert_ + children.size()) % max_in_flight_];
+                if (slot)
+                {
+                    children.push_back(std::move(*slot));
+                    slot.reset();
+                    continue;
+                }
+
+                for (auto& [sequence, member] : awaitCompletions())
+                    arrived_[sequence % max_in_flight_] = std::move(member);
+            }
+            next_insert_ += batch;
+            working_->replaceWorst(children);
+
+            // Keeps the workers busy, including while the caller looks at the snapshot
+            fill();
+        }
+    }
+
+    // The snapshot shares the working population's genomes
+    population_.pushNext(Generation<T>(*working_));
+}
+
+template <typename T>
+void AsyncGeneticAlgorithm<T>::fill()
+{
+    while (next_sequence_ - next_insert_ < max_in_flight_)
+    {
+        util::RNG rng (population_.id(), next_sequence_);
+
+        // Select
+        std::array<uint32_t, 2> parents;
+        selection_function_(*working_, rng, parents);
+
+        // Crossover
+        T offspring = scenario_->crossover((*working_)[parents[0]].value, (*working_)[parents[1]].value, rng);
+
+        // Mutate
+        scenario_->mutate(offspring, rng);
+
+        submit(std::move(offspring));
+    }
+}
+
+template <typename T>
+void AsyncGeneticAlgorithm<T>::submit(T&& genome)
+{
+    ++in_flight_;
+    const uint64_t sequence = next_sequence_++;
+    pool_->submit([scenario = scenario_.get(), completions = completions_.get(), sequence, genome = std::move(genome)]() mutable
+    {
+        Member<T> member;
+        std::exception_ptr error;
+        try
+        {
+            member.fitness = scenario->evaluateFitness(genome);
+            member.value = std::move(genome);
+        }
+        catch (...)
+        {
+            error = std::current_exception();
+        }
+
+        std::lock_guard<std::mutex> lock (completions->mutex);
+        if (error && !completions->error)
+            completions->error = error;
+        completions->members.emplace_back(sequence, std::move(member));
+        completions->ready.notify_one();
+    });
+}
+
+template <typename T>
+std::vector<std::pair<uint64_t, Member<T>>> AsyncGeneticAlgorithm<T>::awaitCompletions()
+{
+    std::vector<std::pair<uint64_t, Member<T>>> members;
+    std::exception_ptr error;
+    {
+        std::unique_lock<std::mutex> lock (completions_->mutex);
+        completions_->ready.wait(lock, [&]{ return !completions_->members.empty(); });
+        members.swap(completions_->members);
+        std::swap(error, completions_->error);
+    }
+    in_flight_ -= members.size();
+
+    if (error)
+    {
+        drain();
+        std::rethrow_exception(error);
+    }
+    return members;
+}
+
+template <typename T>
+void AsyncGeneticAlgorithm<T>::drain()
+{
+    // Discard every evaluation still in flight
+    while (in_flight_ > 0)
+    {
+        std::unique_lock<std::mutex> lock (completions_->mutex);
+        completions_->ready.wait(lock, [&]{ return !completions_->members.empty(); });
+        in_flight_ -= completions_->members.size();
+        completions_->members.clear();
+        completions_->error = nullptr;
+    }
+
+    // Children still to be inserted are bred again from the same streams
+    std::fill(arrived_.begin(), arrived_.end(), std::nullopt);
+    next_sequence_ = next_insert_;
+}
+
+template <typename T>
+void AsyncGeneticAlgorithm<T>::setReproducible(bool reproducible)
+{
+    // Children in flight were bred under the other mode, so they are bred again
+    drain();
+    reproducible_ = reproducible;
+}
+
+template <typename T>
+const std::string& AsyncGeneticAlgorithm<T>::getProblem() const
+{
+    return scenario_->getName();
+}
+
+template <typename T>
+void AsyncGeneticAlgorithm<T>::setRetention(Retention retention, std::size_t n)
+{
+    if (retention == Retention::Replay)
+        throw std::invalid_argument("Asynchronous evolution cannot be replayed");
+
+    population_.setRetention(retention, n);
+}
+
+template <typename T>
+void AsyncGeneticAlgorithm<T>::spillTo(const std::filesystem::path& path)
+{
+    population_.spillTo(path);
+}
+
+template <typename T>
+const PopulationHistory<T>& AsyncGeneticAlgorithm<T>::getPopulation() const
+{
+    return population_;
+}
+
+template <typename T>
+const Serializer<T>& AsyncGeneticAlgorithm<T>::getSerializer()
+{
+    return scenario_->getSerializer();
+}
+
+template <typename T>
+bool AsyncGeneticAlgorithm<T>::savePopulation()
+{
+    return scenario_->getSerializer().save(population_);
+}
+
+template <typename T>
+bool AsyncGeneticAlgorithm<T>::loadPopulation(std::string id)
+{
+    std::optional<PopulationHistory<T>> data = scenario_->getSerializer().load(id);
+
+    if (data.has_value())
+    {
+        drain();
+        population_.load(std::move(data.value()));
+        working_.reset();
+
+        // Numbered as if the loaded run had been evolved here
+        next_sequence_ = next_insert_ = population_.numGenerations() * population_.populationSize();
+        return true;
+    }
+    return false;
+}
+
+template <typename T>
+std::vector<std::string> AsyncGeneticAlgorithm<T>::getSaves() const
+{
+    return scenario_->getSerializer().getSaves();
+}
+
+template <typename T>
+bool AsyncGeneticAlgorithm<T>::deleteSave(const std::string& id) const
+{
+    return scenario_->getSerializer().deleteSave(id);
+}
+
+template <typename T>
+bool AsyncGeneticAlgorithm<T>::deleteAllSaves() const
+{
+    return scenario_->getSerializer().deleteAllSaves();
+}
+
+}
@@ -0,0 +1,68 @@
+#ifndef FITNESS_CACHE_H
+#define FITNESS_CACHE_H
+
+#include "utils/hash.h"
+#include <cstdint>
+#include <optional>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace genetic 
+{
+
+enum class CachePolicy {LRU, Clock};
+
+// Bounded map from genomes to their fitness. Genomes are keyed by a hash of
+// their bytes and verified byte for byte, so a hash collision is never a hit.
+template <typename T>
+class FitnessCache
+{
+    static_assert(std::is_trivially_copyable_v<T>, "T must be trivially copyable to be hashed by its bytes");
+
+    private:
+        static constexpr uint32_t NONE = UINT32_MAX;
+
+        struct Entry
+        {
+            uint64_t hash;
+            T genome;
+            float fitness;
+            bool referenced; // Clock
+            uint32_t prev, next; // LRU, most recent first
+        };
+
+        const std::size_t capacity_;
+        const CachePolicy policy_;
+
+        std::vector<Entry> entries_;
+        std::unordered_multimap<uint64_t, uint32_t> index_;
+        uint32_t head_, tail_; // LRU
+        std::size_t hand_; // Clock
+
+        std::size_t hits_;
+        std::size_t misses_;
+
+        std::optional<uint32_t> locate(const T& genome, uint64_t hash) const;
+        uint32_t evict();
+        void unlink(uint32_t slot);
+        void pushFront(uint32_t slot);
+
+    public:
+        FitnessCache(std::size_t capacity, CachePolicy policy);
+
+        std::optional<float> find(const T& genome);
+        void insert(const T& genome, float fitness);
+        void clear();
+
+        std::size_t size() const;
+        std::size_t capacity() const;
+        CachePolicy policy() const;
+        std::size_t hits() const;
+        std::size_t misses() const;
+};
+
+}
+
+#include "fitness_cache.tpp"
+#endif
\ No newline at end of file
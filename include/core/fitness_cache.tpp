@@ -0,0 +1,182 @@
+#include "fitness_cache.h"
+#include <stdexcept>
+
+namespace genetic 
+{
+
+template <typename T>
+FitnessCache<T>::FitnessCache(std::size_t capacity, CachePolicy policy)
+    : capacity_(capacity)
+    , policy_(policy)
+    , head_(NONE)
+    , tail_(NONE)
+    , hand_(0)
+    , hits_(0)
+    , misses_(0)
+{
+    if (capacity_ == 0 || capacity_ >= NONE)
+        throw std::invalid_argument("Fitness cache capacity must be in the interval [1, 2^32 - 1)");
+
+    entries_.reserve(capacity_);
+    index_.reserve(capacity_);
+}
+
+template <typename T>
+std::optional<uint32_t> FitnessCache<T>::locate(const T& genome, uint64_t hash) const
+{
+    auto [begin, end] = index_.equal_range(hash);
+    for (auto it = begin; it != end; ++it)
+    {
+        if (util::equalBytes(entries_[it->second].genome, genome))
+            return it->second;
+    }
+    return std::nullopt;
+}
+
+template <typename T>
+std::optional<float> FitnessCache<T>::find(const T& genome)
+{
+    std::optional<uint32_t> slot = locate(genome, util::hashBytes(genome));
+    if (!slot.has_value())
+    {
+        ++misses_;
+        return std::nullopt;
+    }
+
+    ++hits_;
+    Entry& entry = entries_[slot.value()];
+    if (policy_ == CachePolicy::LRU)
+    {
+        unlink(slot.value());
+        pushFront(slot.value());
+    }
+    else
+    {
+        entry.referenced = true;
+    }
+    return entry.fitness;
+}
+
+template <typename T>
+void FitnessCache<T>::insert(const T& genome, float fitness)
+{
+    const uint64_t h = util::hashBytes(genome);
+    if (locate(genome, h).has_value())
+        return;
+
+    uint32_t slot;
+    if (entries_.size() < capacity_)
+    {
+        slot = static_cast<uint32_t>(entries_.size());
+        entries_.push_back(Entry{h, genome, fitness, false, NONE, NONE});
+    }
+    else
+    {
+        slot = evict();
+        entries_[slot] = Entry{h, genome, fitness, false, NONE, NONE};
+    }
+
+    index_.emplace(h, slot);
+    if (policy_ == CachePolicy::LRU)
+        pushFront(slot);
+}
+
+template <typename T>
+uint32_t FitnessCache<T>::evict()
+{
+    uint32_t victim;
+    if (policy_ == CachePolicy::LRU)
+    {
+        victim = tail_;
+        unlink(victim);
+    }
+    else
+    {
+        // Give every recently used entry a second chance
+        while (entries_[hand_].referenced)
+        {
+            entries_[hand_].referenced = false;
+            hand_ = (hand_ + 1) % entries_.size();
+        }
+        victim = static_cast<uint32_t>(hand_);
+        hand_ = (hand_ + 1) % entries_.size();
+    }
+
+    auto [begin, end] = index_.equal_range(entries_[victim].hash);
+    for (auto it = begin; it != end; ++it)
+    {
+        if (it->second == victim)
+        {
+            index_.erase(it);
+            break;
+        }
+    }
+    return victim;
+}
+
+template <typename T>
+void FitnessCache<T>::unlink(uint32_t slot)
+{
+    Entry& entry = entries_[slot];
+    (entry.prev == NONE ? head_ : entries_[entry.prev].next) = entry.next;
+    (entry.next == NONE ? tail_ : entries_[entry.next].prev) = entry.prev;
+    entry.prev = NONE;
+    entry.next = NONE;
+}
+
+template <typename T>
+void FitnessCache<T>::pushFront(uint32_t slot)
+{
+    Entry& entry = entries_[slot];
+    entry.prev = NONE;
+    entry.next = head_;
+    if (head_ != NONE)
+        entries_[head_].prev = slot;
+    head_ = slot;
+    if (tail_ == NONE)
+        tail_ = slot;
+}
+
+template <typename T>
+void FitnessCache<T>::clear()
+{
+    entries_.clear();
+    index_.clear();
+    head_ = NONE;
+    tail_ = NONE;
+    hand_ = 0;
+    hits_ = 0;
+    misses_ = 0;
+}
+
+template <typename T>
+std::size_t FitnessCache<T>::size() const
+{
+    return entries_.size();
+}
+
+template <typename T>
+std::size_t FitnessCache<T>::capacity() const
+{
+    return capacity_;
+}
+
+template <typename T>
+CachePolicy FitnessCache<T>::policy() const
+{
+    return policy_;
+}
+
+template <typename T>
+std::size_t FitnessCache<T>::hits() const
+{
+    return hits_;
+}
+
+template <typename T>
+std::size_t FitnessCache<T>::misses() const
+{
+    return misses_;
+}
+
+}
\ No newline at end of file
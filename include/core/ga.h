@@ -1,40 +1,20 @@
 #ifndef GA_H
 #define GA_H
 
+#include "static_ga.h"
 #include "scenario.h"
-#include "member.h"
-#include "population_history.h"
 #include "operator/selection.h"
-#include "serialization/serializer.h"
-#include "utils/rng.h"
 
-#include <optional>
-#include <vector>
-#include <functional>
-#include <string>
-#include <filesystem>
-#include <type_traits>
 #include <memory>
 
 namespace genetic 
 {
 
+// Runtime-polymorphic genetic algorithm: the scenario is chosen through
+// Scenario's virtual interface and selection through a std::function
 template <typename T>
-class GeneticAlgorithm
+class GeneticAlgorithm : public StaticGeneticAlgorithm<PolymorphicScenario<T>, selection::Function<T>>
 {
-    private:
-        std::unique_ptr<Scenario<T>> scenario_;
-
-        const float elitism_rate_;
-
-        selection::Function<T> selection_function_;
-
-        PopulationHistory<T> population_;
-
-        util::RNG rng_;
-
-        inline std::size_t numElites();
-        
     public:
         GeneticAlgorithm(
             std::unique_ptr<Scenario<T>> scenario,
@@ -45,18 +25,6 @@ class GeneticAlgorithm
         GeneticAlgorithm(
             std::unique_ptr<Scenario<T>> scenario
         );
-        void restart();
-        void evolve();
-        
-        const std::string& getProblem() const;
-        const PopulationHistory<T>& getPopulation() const;
-
-        // Expose serializer functionality
-        bool savePopulation();
-        bool loadPopulation(std::string id);
-        std::vector<std::string> getSaves() const;
-        bool deleteSave(const std::string& id) const;
-        bool deleteAllSaves() const;
 };
 
 }
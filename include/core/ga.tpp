@@ -1,6 +1,4 @@
 #include "ga.h"
-#include <cassert>
-#include <ctime>
 
 namespace genetic 
 {
@@ -12,129 +10,18 @@ GeneticAlgorithm<T>::GeneticAlgorithm(
     std::size_t population_size,
     float elitism_rate
 )
-    : scenario_(std::move(scenario))
-    , selection_function_(select)
-    , population_(0, population_size)
-    , elitism_rate_(elitism_rate)
-    , rng_()
-{
-    if (!(elitism_rate_ >= 0.f && elitism_rate_ <= 1.f))
-        throw std::invalid_argument("elitism_rate must be in the interval [0, 1]");
-
-    restart();
-}
+    : StaticGeneticAlgorithm<PolymorphicScenario<T>, selection::Function<T>>(
+        PolymorphicScenario<T>(std::move(scenario)),
+        std::move(select),
+        population_size,
+        elitism_rate
+    )
+{}
 
 template <typename T>
 GeneticAlgorithm<T>::GeneticAlgorithm
 (
     std::unique_ptr<Scenario<T>> scenario
-): GeneticAlgorithm(scenario, selection::tournament<T, 5>, 1000, 1.f) {};
-
-template <typename T>
-void GeneticAlgorithm<T>::restart()
-{
-    std::size_t size = population_.populationSize();
-    population_.restart(rng_.index(UINT32_MAX), size);
-    
-    std::vector<Member<T>> next;
-    next.reserve(size);
-    while (next.size() < size)
-    {
-        T member = scenario_->birth(rng_);
-        next.emplace_back(scenario_->evaluateFitness(member), std::move(member));
-    }
-
-    population_.pushNext(std::move(next));
-}
-
-template <typename T>
-void GeneticAlgorithm<T>::evolve()
-{
-    const Generation<T>& parents = population_.current();
-
-    std::vector<Member<T>> next;
-    next.reserve(population_.populationSize());
-
-    // Elitism
-    for (int i = 0; i < numElites(); ++i)
-    {
-        next.push_back(parents[parents.size() - i - 1]);
-    }
-
-    // Mutation & Crossover
-    while (next.size() < population_.populationSize())
-    {
-        // Select
-        const T& parent_a = selection_function_(parents, rng_);
-        const T& parent_b = selection_function_(parents, rng_);
-
-        // Crossover
-        T offspring = scenario_->crossover(parent_a, parent_b, rng_);
-
-        // Mutate
-        scenario_->mutate(offspring, rng_);
-        
-        /// Add to new generation
-        next.emplace_back(scenario_->evaluateFitness(offspring), std::move(offspring));
-    }
-
-    // Finalize
-    population_.pushNext(std::move(next));
-}
-
-template <typename T>
-inline std::size_t GeneticAlgorithm<T>::numElites()
-{
-    return population_.populationSize() * elitism_rate_;
-}
-
-template <typename T>
-const std::string& GeneticAlgorithm<T>::getProblem() const
-{
-    return scenario_->getName();
-}
-
-template <typename T>
-const PopulationHistory<T>& GeneticAlgorithm<T>::getPopulation() const
-{
-    return population_;
-}
-
-template <typename T>
-bool GeneticAlgorithm<T>::savePopulation()
-{
-    return scenario_->getSerializer().save(population_);
-}
-
-template <typename T>
-bool GeneticAlgorithm<T>::loadPopulation(std::string id)
-{
-    std::optional<PopulationHistory<T>> data = scenario_->getSerializer().load(id);
-
-    if (data.has_value())
-    { 
-        population_ = data.value();
-        return true;
-    }
-    return false;
-}
-
-template <typename T>
-std::vector<std::string> GeneticAlgorithm<T>::getSaves() const
-{
-    return scenario_->getSerializer().getSaves();
-}
-
-template <typename T>
-bool GeneticAlgorithm<T>::deleteSave(const std::string& id) const
-{
-    return scenario_->getSerializer().deleteSave(id);
-}
-
-template <typename T>
-bool GeneticAlgorithm<T>::deleteAllSaves() const
-{
-    return scenario_->getSerializer().deleteAllSaves();
-}
+): GeneticAlgorithm(std::move(scenario), selection::tournament<T, 5>, 1000, 1.f) {};
 
 }
\ No newline at end of file
@@ -2,6 +2,16 @@
 #define GENERATION_H
 
 #include "member.h"
+#include "genome_pool.h"
+#include "generation_stats.h"
+#include "utils/aligned_allocator.h"
+#include "utils/alias_table.h"
+#include <vector>
+#include <span>
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <cstdint>
 
 namespace genetic 
 {
@@ -14,18 +24,87 @@ class Generation {
     friend class Serializer<T>;
 
     private:
-        std::vector<Member<T>> members_;
+        std::shared_ptr<GenomePool<T>> pool_;
+        // Members in no particular order, as parallel arrays so that selection,
+        // sorting and statistics scan fitness without touching the genomes
+        std::vector<float, util::AlignedAllocator<float>> fitness_;
+        std::vector<GenomeHandle> handles_; // Each holding one reference
         float total_fitness_; // Relevant to some selection functions
+        std::size_t fittest_index_;
+        std::size_t lowest_index_;
+
+        // Entry indices as a min-heap on (fitness, index), so that replaceWorst
+        // finds the least fit members without scanning. Built on first use.
+        std::vector<uint32_t> worst_heap_;
+        bool has_worst_heap_;
+        std::size_t replaced_since_sum_; // Total fitness is summed afresh after a generation's worth
+
+        // Entry indices from least to most fit, a table sampling members in proportion
+        // to fitness, and fitness statistics, each computed when first asked for
+        mutable std::vector<uint32_t> rank_order_;
+        mutable std::atomic<bool> ranked_;
+        mutable util::AliasTable fitness_table_;
+        mutable std::atomic<bool> has_fitness_table_;
+        mutable GenerationStats stats_;
+        mutable std::atomic<bool> has_stats_;
+        mutable std::mutex lazy_mutex_;
+
+        void retainAll();
+        void releaseAll();
+        void assign(std::span<const Member<GenomeHandle>> entries);
+        void scan();
+        bool worse(uint32_t a, uint32_t b) const;
+        void invalidate();
+        const std::vector<uint32_t>& rankOrder() const;
     
     public:
-        Generation(std::vector<Member<T>>&& members);
-        const Member<T>& operator[](std::size_t index) const;
-        const std::vector<Member<T>>& members() const;
+        Generation(std::shared_ptr<GenomePool<T>> pool, std::vector<Member<GenomeHandle>>&& entries);
+        Generation(std::shared_ptr<GenomePool<T>> pool, std::vector<Member<T>>&& members);
+        Generation(const Generation& other);
+        Generation(Generation&& other) noexcept;
+        Generation& operator=(const Generation& other);
+        Generation& operator=(Generation&& other) noexcept;
+        ~Generation();
+
+        // Members in no particular order, e.g. for selection that does not need ranks
+        MemberRef<T> operator[](std::size_t index) const;
+        Member<GenomeHandle> entry(std::size_t index) const;
+        float fitness(std::size_t index) const;
+        std::span<const float> fitness() const; // Aligned to a cache line
+
+        // The member of the given rank, 0 being the least fit. The first call
+        // sorts the generation; it is safe to make from several threads at once.
+        MemberRef<T> byRank(std::size_t rank) const;
+        uint32_t indexOfRank(std::size_t rank) const;
+
+        // Samples member indices in proportion to their fitness, which must not be
+        // negative. Built on first call; safe to call from several threads.
+        const util::AliasTable& fitnessTable() const;
+
+        // Indices of the k fittest members, fittest first, without sorting the rest
+        void fittestIndices(std::size_t k, std::vector<uint32_t>& indices) const;
+
+        std::vector<Member<T>> members() const; // Sorted by fitness
+        const std::shared_ptr<GenomePool<T>>& pool() const;
         std::size_t size() const;
-        const Member<T>& fittest() const;
+        MemberRef<T> fittest() const;
+        std::size_t fittestIndex() const;
         float fittestScore() const;
         float lowestScore() const;
         float totalFitness() const;
+        const GenerationStats& stats() const; // Computed on first call; safe to call from several threads
+        std::size_t memoryUsage() const; // Excludes the shared genome pool
+
+        // Replace the least fit members in place, in O(k log n) for k replacements
+        // once the first call has built its index. Takes over one pool reference
+        // per replacement handle.
+        void replaceWorst(std::span<Member<GenomeHandle>> replacements);
+        void replaceWorst(std::span<Member<T>> replacements);
+
+        // Replace every member, taking over one pool reference per entry. The
+        // entries are copied into the existing arrays, and `entries` is emptied
+        // but keeps its capacity, so the caller can fill it again without allocating.
+        void replaceAll(std::vector<Member<GenomeHandle>>& entries);
 };
 
 }
@@ -1,60 +1,346 @@
 #include "generation.h"
 #include <stdexcept>
 #include <algorithm>
+#include <numeric>
 
 namespace genetic 
 {
 
 template <typename T>
-Generation<T>::Generation(std::vector<Member<T>>&& members)
-    : members_(members)
-    , total_fitness_(0.f)
+Generation<T>::Generation(std::shared_ptr<GenomePool<T>> pool, std::vector<Member<GenomeHandle>>&& entries)
+    : pool_(std::move(pool))
+    , has_worst_heap_(false)
+    , replaced_since_sum_(0)
+    , ranked_(false)
+    , has_fitness_table_(false)
+    , has_stats_(false)
 {
-    if (members_.size() == 0)
+    if (entries.size() == 0)
         throw std::invalid_argument("Generation size must be greater than 0");
 
-    std::sort(members_.begin(), members_.end());
+    assign(entries);
+    scan();
+}
+
+template <typename T>
+Generation<T>::Generation(std::shared_ptr<GenomePool<T>> pool, std::vector<Member<T>>&& members)
+    : pool_(std::move(pool))
+    , has_worst_heap_(false)
+    , replaced_since_sum_(0)
+    , ranked_(false)
+    , has_fitness_table_(false)
+    , has_stats_(false)
+{
+    if (members.size() == 0)
+        throw std::invalid_argument("Generation size must be greater than 0");
+
+    fitness_.reserve(members.size());
+    handles_.reserve(members.size());
+    for (Member<T>& member : members)
+    {
+        fitness_.push_back(member.fitness);
+        handles_.push_back(pool_->insert(std::move(member.value)));
+    }
+
+    scan();
+}
+
+template <typename T>
+Generation<T>::Generation(const Generation& other)
+    : pool_(other.pool_)
+    , fitness_(other.fitness_)
+    , handles_(other.handles_)
+    , total_fitness_(other.total_fitness_)
+    , fittest_index_(other.fittest_index_)
+    , lowest_index_(other.lowest_index_)
+    , has_worst_heap_(false)
+    , replaced_since_sum_(other.replaced_since_sum_)
+    , ranked_(false)
+    , has_fitness_table_(false)
+    , stats_(other.stats_)
+    , has_stats_(other.has_stats_.load(std::memory_order_acquire))
+{
+    retainAll();
+}
+
+template <typename T>
+Generation<T>::Generation(Generation&& other) noexcept
+    : pool_(std::move(other.pool_))
+    , fitness_(std::move(other.fitness_))
+    , handles_(std::move(other.handles_))
+    , total_fitness_(other.total_fitness_)
+    , fittest_index_(other.fittest_index_)
+    , lowest_index_(other.lowest_index_)
+    , worst_heap_(std::move(other.worst_heap_))
+    , has_worst_heap_(other.has_worst_heap_)
+    , replaced_since_sum_(other.replaced_since_sum_)
+    , rank_order_(std::move(other.rank_order_))
+    , ranked_(other.ranked_.load(std::memory_order_acquire))
+    , fitness_table_(std::move(other.fitness_table_))
+    , has_fitness_table_(other.has_fitness_table_.load(std::memory_order_acquire))
+    , stats_(other.stats_)
+    , has_stats_(other.has_stats_.load(std::memory_order_acquire))
+{
+    other.fitness_.clear();
+    other.handles_.clear();
+    other.has_worst_heap_ = false;
+    other.ranked_.store(false, std::memory_order_relaxed);
+    other.has_fitness_table_.store(false, std::memory_order_relaxed);
+    other.has_stats_.store(false, std::memory_order_relaxed);
+}
+
+template <typename T>
+Generation<T>& Generation<T>::operator=(const Generation& other)
+{
+    if (this != &other)
+    {
+        releaseAll();
+        pool_ = other.pool_;
+        fitness_ = other.fitness_;
+        handles_ = other.handles_;
+        total_fitness_ = other.total_fitness_;
+        fittest_index_ = other.fittest_index_;
+        lowest_index_ = other.lowest_index_;
+        has_worst_heap_ = false;
+        replaced_since_sum_ = other.replaced_since_sum_;
+        ranked_.store(false, std::memory_order_relaxed);
+        has_fitness_table_.store(false, std::memory_order_relaxed);
+        stats_ = other.stats_;
+        has_stats_.store(other.has_stats_.load(std::memory_order_acquire), std::memory_order_relaxed);
+        retainAll();
+    }
+    return *this;
+}
 
-    for (Member<T>& member : members_)
+template <typename T>
+Generation<T>& Generation<T>::operator=(Generation&& other) noexcept
+{
+    if (this != &other)
     {
-        total_fitness_ += member.fitness;
+        releaseAll();
+        pool_ = std::move(other.pool_);
+        fitness_.swap(other.fitness_);
+        handles_.swap(other.handles_);
+        total_fitness_ = other.total_fitness_;
+        fittest_index_ = other.fittest_index_;
+        lowest_index_ = other.lowest_index_;
+        worst_heap_.swap(other.worst_heap_);
+        has_worst_heap_ = other.has_worst_heap_;
+        replaced_since_sum_ = other.replaced_since_sum_;
+        rank_order_.swap(other.rank_order_);
+        ranked_.store(other.ranked_.load(std::memory_order_acquire), std::memory_order_relaxed);
+        std::swap(fitness_table_, other.fitness_table_);
+        has_fitness_table_.store(other.has_fitness_table_.load(std::memory_order_acquire), std::memory_order_relaxed);
+        stats_ = other.stats_;
+        has_stats_.store(other.has_stats_.load(std::memory_order_acquire), std::memory_order_relaxed);
+        other.fitness_.clear();
+        other.handles_.clear();
+        other.has_worst_heap_ = false;
+        other.ranked_.store(false, std::memory_order_relaxed);
+        other.has_fitness_table_.store(false, std::memory_order_relaxed);
+        other.has_stats_.store(false, std::memory_order_relaxed);
     }
+    return *this;
+}
+
+template <typename T>
+Generation<T>::~Generation()
+{
+    releaseAll();
 }
 
 template <typename T>
-const Member<T>& Generation<T>::operator[](std::size_t index) const
+void Generation<T>::retainAll()
 {
-    return members_[index];
+    for (GenomeHandle handle : handles_)
+        pool_->retain(handle);
 }
 
 template <typename T>
-const std::vector<Member<T>>& Generation<T>::members() const
+void Generation<T>::releaseAll()
 {
-    return members_;
+    for (GenomeHandle handle : handles_)
+        pool_->release(handle);
+}
+
+template <typename T>
+void Generation<T>::assign(std::span<const Member<GenomeHandle>> entries)
+{
+    fitness_.resize(entries.size());
+    handles_.resize(entries.size());
+    for (std::size_t i = 0; i < entries.size(); ++i)
+    {
+        fitness_[i] = entries[i].fitness;
+        handles_[i] = entries[i].value;
+    }
+}
+
+template <typename T>
+void Generation<T>::scan()
+{
+    // One linear pass in place of sorting; rank order is only built if asked for
+    total_fitness_ = 0.f;
+    fittest_index_ = 0;
+    lowest_index_ = 0;
+    for (std::size_t i = 0; i < fitness_.size(); ++i)
+    {
+        total_fitness_ += fitness_[i];
+        if (fitness_[i] >= fitness_[fittest_index_])
+            fittest_index_ = i;
+        if (fitness_[i] < fitness_[lowest_index_])
+            lowest_index_ = i;
+    }
+    has_worst_heap_ = false;
+    replaced_since_sum_ = 0;
+    invalidate();
+}
+
+template <typename T>
+bool Generation<T>::worse(uint32_t a, uint32_t b) const
+{
+    // Ties are broken by index, as in rank order
+    return fitness_[a] < fitness_[b] || (fitness_[a] == fitness_[b] && a < b);
+}
+
+template <typename T>
+void Generation<T>::invalidate()
+{
+    ranked_.store(false, std::memory_order_relaxed);
+    has_fitness_table_.store(false, std::memory_order_relaxed);
+    has_stats_.store(false, std::memory_order_relaxed);
+}
+
+template <typename T>
+const std::vector<uint32_t>& Generation<T>::rankOrder() const
+{
+    if (ranked_.load(std::memory_order_acquire))
+        return rank_order_;
+
+    std::lock_guard<std::mutex> lock (lazy_mutex_);
+    if (!ranked_.load(std::memory_order_relaxed))
+    {
+        // Ties are broken by index so that the order does not depend on the sort
+        rank_order_.resize(fitness_.size());
+        std::iota(rank_order_.begin(), rank_order_.end(), 0u);
+        std::sort(rank_order_.begin(), rank_order_.end(), [this](uint32_t a, uint32_t b)
+        {
+            return fitness_[a] < fitness_[b] || (fitness_[a] == fitness_[b] && a < b);
+        });
+        ranked_.store(true, std::memory_order_release);
+    }
+    return rank_order_;
+}
+
+template <typename T>
+MemberRef<T> Generation<T>::operator[](std::size_t index) const
+{
+    return {fitness_[index], (*pool_)[handles_[index]]};
+}
+
+template <typename T>
+Member<GenomeHandle> Generation<T>::entry(std::size_t index) const
+{
+    return {fitness_[index], handles_[index]};
+}
+
+template <typename T>
+float Generation<T>::fitness(std::size_t index) const
+{
+    return fitness_[index];
+}
+
+template <typename T>
+std::span<const float> Generation<T>::fitness() const
+{
+    return fitness_;
+}
+
+template <typename T>
+MemberRef<T> Generation<T>::byRank(std::size_t rank) const
+{
+    return (*this)[rankOrder()[rank]];
+}
+
+template <typename T>
+uint32_t Generation<T>::indexOfRank(std::size_t rank) const
+{
+    return rankOrder()[rank];
+}
+
+template <typename T>
+const util::AliasTable& Generation<T>::fitnessTable() const
+{
+    if (has_fitness_table_.load(std::memory_order_acquire))
+        return fitness_table_;
+
+    std::lock_guard<std::mutex> lock (lazy_mutex_);
+    if (!has_fitness_table_.load(std::memory_order_relaxed))
+    {
+        fitness_table_.build(fitness_);
+        has_fitness_table_.store(true, std::memory_order_release);
+    }
+    return fitness_table_;
+}
+
+template <typename T>
+void Generation<T>::fittestIndices(std::size_t k, std::vector<uint32_t>& indices) const
+{
+    k = std::min(k, fitness_.size());
+    indices.resize(fitness_.size());
+    std::iota(indices.begin(), indices.end(), 0u);
+    std::partial_sort(indices.begin(), indices.begin() + k, indices.end(), [this](uint32_t a, uint32_t b)
+    {
+        return fitness_[a] > fitness_[b] || (fitness_[a] == fitness_[b] && a > b);
+    });
+    indices.resize(k);
+}
+
+template <typename T>
+std::vector<Member<T>> Generation<T>::members() const
+{
+    std::vector<Member<T>> members;
+    members.reserve(handles_.size());
+    for (uint32_t index : rankOrder())
+    {
+        members.emplace_back(fitness_[index], (*pool_)[handles_[index]]);
+    }
+    return members;
+}
+
+template <typename T>
+const std::shared_ptr<GenomePool<T>>& Generation<T>::pool() const
+{
+    return pool_;
 }
 
 template <typename T>
 std::size_t Generation<T>::size() const
 {
-    return members_.size();
+    return handles_.size();
+}
+
+template <typename T>
+MemberRef<T> Generation<T>::fittest() const
+{
+    return (*this)[fittest_index_];
 }
 
 template <typename T>
-const Member<T>& Generation<T>::fittest() const
+std::size_t Generation<T>::fittestIndex() const
 {
-    return members_.back();
+    return fittest_index_;
 }
 
 template <typename T>
 float Generation<T>::fittestScore() const
 {
-    return fittest().fitness;
+    return fitness_[fittest_index_];
 }
 
 template <typename T>
 float Generation<T>::lowestScore() const
 {
-    return members_[0].fitness;
+    return fitness_[lowest_index_];
 }
 
 template <typename T>
@@ -63,4 +349,135 @@ float Generation<T>::totalFitness() const
     return total_fitness_;
 }
 
-}
\ No newline at end of file
+template <typename T>
+const GenerationStats& Generation<T>::stats() const
+{
+    if (has_stats_.load(std::memory_order_acquire))
+        return stats_;
+
+    std::lock_guard<std::mutex> lock (lazy_mutex_);
+    if (!has_stats_.load(std::memory_order_relaxed))
+    {
+        // Kept per thread, so that computing every generation's statistics allocates nothing
+        thread_local std::vector<float> scratch;
+        stats_ = GenerationStats::of(fitness_, total_fitness_, scratch);
+        has_stats_.store(true, std::memory_order_release);
+    }
+    return stats_;
+}
+
+template <typename T>
+std::size_t Generation<T>::memoryUsage() const
+{
+    return sizeof(Generation<T>) + fitness_.capacity() * sizeof(float)
+        + handles_.capacity() * sizeof(GenomeHandle) + worst_heap_.capacity() * sizeof(uint32_t)
+        + rank_order_.capacity() * sizeof(uint32_t)
+        + fitness_table_.memoryUsage();
+}
+
+template <typename T>
+void Generation<T>::replaceWorst(std::span<Member<GenomeHandle>> replacements)
+{
+    const std::size_t k = replacements.size();
+    if (k > handles_.size())
+        throw std::invalid_argument("Cannot replace more members than the generation holds");
+    if (k == 0)
+        return;
+
+    // The heap's top is the least fit member
+    auto heap_order = [this](uint32_t a, uint32_t b) { return worse(b, a); };
+    if (!has_worst_heap_)
+    {
+        worst_heap_.resize(handles_.size());
+        std::iota(worst_heap_.begin(), worst_heap_.end(), 0u);
+        std::make_heap(worst_heap_.begin(), worst_heap_.end(), heap_order);
+        has_worst_heap_ = true;
+    }
+
+    // Take out all k least fit before any replacement goes in, then fill them in index order
+    thread_local std::vector<uint32_t> replaced;
+    replaced.clear();
+    for (std::size_t j = 0; j < k; ++j)
+    {
+        std::pop_heap(worst_heap_.begin(), worst_heap_.end(), heap_order);
+        replaced.push_back(worst_heap_.back());
+        worst_heap_.pop_back();
+    }
+    std::sort(replaced.begin(), replaced.end());
+
+    bool lost_fittest = false;
+    for (std::size_t j = 0; j < k; ++j)
+    {
+        const uint32_t i = replaced[j];
+        lost_fittest |= i == fittest_index_;
+        total_fitness_ += replacements[j].fitness - fitness_[i];
+
+        pool_->release(handles_[i]);
+        fitness_[i] = replacements[j].fitness;
+        handles_[i] = replacements[j].value;
+
+        worst_heap_.push_back(i);
+        std::push_heap(worst_heap_.begin(), worst_heap_.end(), heap_order);
+    }
+    lowest_index_ = worst_heap_.front();
+
+    // The fittest member is only replaced when nearly all members tie, so a full pass is rare
+    if (lost_fittest)
+    {
+        fittest_index_ = 0;
+        for (std::size_t i = 1; i < fitness_.size(); ++i)
+        {
+            if (fitness_[i] >= fitness_[fittest_index_])
+                fittest_index_ = i;
+        }
+    }
+    else
+    {
+        for (uint32_t i : replaced)
+        {
+            if (fitness_[i] > fitness_[fittest_index_] || (fitness_[i] == fitness_[fittest_index_] && i > fittest_index_))
+                fittest_index_ = i;
+        }
+    }
+
+    // Summed afresh now and then, so that rounding errors do not accumulate over many replacements
+    replaced_since_sum_ += k;
+    if (replaced_since_sum_ >= fitness_.size())
+    {
+        total_fitness_ = std::accumulate(fitness_.begin(), fitness_.end(), 0.f);
+        replaced_since_sum_ = 0;
+    }
+
+    invalidate();
+}
+
+template <typename T>
+void Generation<T>::replaceAll(std::vector<Member<GenomeHandle>>& entries)
+{
+    if (entries.size() == 0)
+        throw std::invalid_argument("Generation size must be greater than 0");
+
+    // Copied into the existing arrays, which keep their capacity, rather than swapped
+    releaseAll();
+    assign(entries);
+    entries.clear();
+
+    scan();
+}
+
+template <typename T>
+void Generation<T>::replaceWorst(std::span<Member<T>> replacements)
+{
+    if (replacements.size() > handles_.size())
+        throw std::invalid_argument("Cannot replace more members than the generation holds");
+
+    std::vector<Member<GenomeHandle>> entries;
+    entries.reserve(replacements.size());
+    for (Member<T>& replacement : replacements)
+    {
+        entries.emplace_back(replacement.fitness, pool_->insert(std::move(replacement.value)));
+    }
+    replaceWorst(entries);
+}
+
+}
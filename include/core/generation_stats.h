@@ -0,0 +1,88 @@
+#ifndef GENERATION_STATS_H
+#define GENERATION_STATS_H
+
+#include <algorithm>
+#include <array>
+#include <span>
+#include <vector>
+#include <cstddef>
+
+namespace genetic
+{
+
+// Distribution of one generation's fitness scores. Quantiles are nearest-rank.
+struct GenerationStats
+{
+    float fittest_score;
+    float lowest_score;
+    float total_fitness;
+    float mean;
+    float variance;
+    float median;
+    float lower_quartile;
+    float upper_quartile;
+
+    // The total is taken rather than summed again, so that it matches the
+    // generation's own total exactly. Quantiles are selected on a copy in scratch.
+    static GenerationStats of(std::span<const float> fitness, float total_fitness, std::vector<float>& scratch)
+    {
+        const std::size_t n = fitness.size();
+        GenerationStats stats {};
+        stats.total_fitness = total_fitness;
+        if (n == 0)
+            return stats;
+
+        stats.mean = total_fitness / n;
+
+        // Independent lanes let the compiler keep each accumulator in one vector register
+        constexpr std::size_t LANES = 8;
+        std::array<float, LANES> lowest, fittest, squares {};
+        lowest.fill(fitness[0]);
+        fittest.fill(fitness[0]);
+        std::size_t i = 0;
+        for (; i + LANES <= n; i += LANES)
+        {
+            for (std::size_t lane = 0; lane < LANES; ++lane)
+            {
+                const float x = fitness[i + lane];
+                const float deviation = x - stats.mean;
+                squares[lane] += deviation * deviation;
+                lowest[lane] = std::min(lowest[lane], x);
+                fittest[lane] = std::max(fittest[lane], x);
+            }
+        }
+        for (std::size_t lane = 0; i < n; ++i, ++lane)
+        {
+            const float deviation = fitness[i] - stats.mean;
+            squares[lane] += deviation * deviation;
+            lowest[lane] = std::min(lowest[lane], fitness[i]);
+            fittest[lane] = std::max(fittest[lane], fitness[i]);
+        }
+
+        float sum_of_squares = 0.f;
+        for (float square : squares)
+            sum_of_squares += square;
+        stats.variance = sum_of_squares / n;
+        stats.lowest_score = *std::min_element(lowest.begin(), lowest.end());
+        stats.fittest_score = *std::max_element(fittest.begin(), fittest.end());
+
+        // Each selection leaves the ranks below and above it partitioned, narrowing the next
+        scratch.assign(fitness.begin(), fitness.end());
+        std::span<float> partitioned = scratch;
+        const std::size_t median = (n - 1) / 2;
+        const std::size_t lower = (n - 1) / 4;
+        const std::size_t upper = (3 * (n - 1)) / 4;
+        std::nth_element(partitioned.begin(), partitioned.begin() + median, partitioned.end());
+        stats.median = partitioned[median];
+        std::nth_element(partitioned.begin(), partitioned.begin() + lower, partitioned.begin() + median);
+        stats.lower_quartile = lower < median ? partitioned[lower] : stats.median;
+        std::nth_element(partitioned.begin() + median, partitioned.begin() + upper, partitioned.end());
+        stats.upper_quartile = partitioned[upper];
+
+        return stats;
+    }
+};
+
+}
+
+#endif
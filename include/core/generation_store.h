@@ -0,0 +1,63 @@
+#ifndef GENERATION_STORE_H
+#define GENERATION_STORE_H
+
+#include "member.h"
+#include "generation.h"
+#include <filesystem>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+namespace genetic 
+{
+
+// Memory-mapped file holding generations as a fixed-stride array of Member<T>:
+// generation i occupies population_size members starting at member
+// i * population_size, in the order the Generation holds them. Generations that were never written
+// leave holes, which most filesystems store sparsely. The kernel pages cold
+// generations out, so a long history costs disk space rather than memory.
+// Maps with mmap on POSIX systems and CreateFileMapping on Windows.
+template <typename T>
+class GenerationStore
+{
+    static_assert(std::is_trivially_copyable_v<T>, "T must be trivially copyable to be stored in a mapped file");
+
+    private:
+        std::filesystem::path path_;
+        std::size_t population_size_;
+#ifdef _WIN32
+        void* file_;         // HANDLE of the open file
+        void* file_mapping_; // HANDLE of its mapping object, while mapped
+#else
+        int fd_;
+#endif
+        Member<T>* mapping_;
+        std::size_t capacity_; // In generations
+        std::vector<bool> stored_;
+        std::size_t num_stored_;
+
+        void map(std::size_t capacity);
+        void unmap();
+
+    public:
+        // Creates the file at path, replacing any previous one
+        GenerationStore(std::filesystem::path path, std::size_t population_size);
+        ~GenerationStore();
+
+        GenerationStore(const GenerationStore&) = delete;
+        GenerationStore& operator=(const GenerationStore&) = delete;
+
+        // Spans returned by operator[] are invalidated when a write grows the file
+        void write(std::size_t index, const Generation<T>& generation);
+        bool contains(std::size_t index) const;
+        std::span<const Member<T>> operator[](std::size_t index) const;
+
+        std::size_t numStored() const;
+        std::size_t fileSize() const;
+        const std::filesystem::path& path() const;
+};
+
+}
+
+#include "generation_store.tpp"
+#endif
\ No newline at end of file
@@ -0,0 +1,184 @@
+#include "generation_store.h"
+#include <cerrno>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace genetic 
+{
+
+template <typename T>
+GenerationStore<T>::GenerationStore(std::filesystem::path path, std::size_t population_size)
+    : path_(std::move(path))
+    , population_size_(population_size)
+#ifdef _WIN32
+    , file_(INVALID_HANDLE_VALUE)
+    , file_mapping_(nullptr)
+#else
+    , fd_(-1)
+#endif
+    , mapping_(nullptr)
+    , capacity_(0)
+    , num_stored_(0)
+{
+    if (population_size_ == 0)
+        throw std::invalid_argument("Population size must be greater than 0");
+
+    if (path_.has_parent_path())
+        std::filesystem::create_directories(path_.parent_path());
+
+    // Unlink any previous file rather than truncate it in place, so that a store
+    // still mapping it keeps its pages. Windows refuses both while it is mapped.
+    std::error_code ignored;
+    std::filesystem::remove(path_, ignored);
+
+#ifdef _WIN32
+    file_ = ::CreateFileW(path_.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr,
+        CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file_ == INVALID_HANDLE_VALUE)
+        throw std::runtime_error("Failed to open \"" + path_.string() + "\": " + std::system_category().message(::GetLastError()));
+#else
+    fd_ = ::open(path_.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd_ < 0)
+        throw std::runtime_error("Failed to open \"" + path_.string() + "\": " + std::strerror(errno));
+#endif
+}
+
+template <typename T>
+GenerationStore<T>::~GenerationStore()
+{
+    unmap();
+#ifdef _WIN32
+    if (file_ != INVALID_HANDLE_VALUE)
+        ::CloseHandle(file_);
+#else
+    if (fd_ >= 0)
+        ::close(fd_);
+#endif
+}
+
+template <typename T>
+void GenerationStore<T>::map(std::size_t capacity)
+{
+    const std::size_t stride = population_size_ * sizeof(Member<T>);
+    const std::size_t size = capacity * stride;
+
+#ifdef _WIN32
+    // A mapped file cannot be resized, so the old view goes first
+    unmap();
+
+    LARGE_INTEGER end;
+    end.QuadPart = static_cast<LONGLONG>(size);
+    if (!::SetFilePointerEx(file_, end, nullptr, FILE_BEGIN) || !::SetEndOfFile(file_))
+        throw std::runtime_error("Failed to grow \"" + path_.string() + "\": " + std::system_category().message(::GetLastError()));
+
+    file_mapping_ = ::CreateFileMappingW(file_, nullptr, PAGE_READWRITE,
+        static_cast<DWORD>(static_cast<uint64_t>(size) >> 32), static_cast<DWORD>(size), nullptr);
+    void* mapping = file_mapping_ ? ::MapViewOfFile(file_mapping_, FILE_MAP_ALL_ACCESS, 0, 0, size) : nullptr;
+    if (!mapping)
+    {
+        const DWORD error = ::GetLastError();
+        unmap();
+        throw std::runtime_error("Failed to map \"" + path_.string() + "\": " + std::system_category().message(error));
+    }
+#else
+    if (::ftruncate(fd_, static_cast<off_t>(size)) != 0)
+        throw std::runtime_error("Failed to grow \"" + path_.string() + "\": " + std::strerror(errno));
+
+    unmap();
+    void* mapping = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (mapping == MAP_FAILED)
+        throw std::runtime_error("Failed to map \"" + path_.string() + "\": " + std::strerror(errno));
+#endif
+
+    mapping_ = static_cast<Member<T>*>(mapping);
+    capacity_ = capacity;
+}
+
+template <typename T>
+void GenerationStore<T>::unmap()
+{
+#ifdef _WIN32
+    if (mapping_)
+        ::UnmapViewOfFile(mapping_);
+    if (file_mapping_)
+        ::CloseHandle(file_mapping_);
+    file_mapping_ = nullptr;
+#else
+    if (mapping_)
+        ::munmap(mapping_, capacity_ * population_size_ * sizeof(Member<T>));
+#endif
+    mapping_ = nullptr;
+}
+
+template <typename T>
+void GenerationStore<T>::write(std::size_t index, const Generation<T>& generation)
+{
+    if (generation.size() != population_size_)
+        throw std::invalid_argument("Generation size conflicts with the store's population size");
+
+    // Grow geometrically so that remapping is rare
+    if (index >= capacity_)
+        map(std::max(index + 1, capacity_ * 2));
+
+    Member<T>* slot = mapping_ + index * population_size_;
+    for (std::size_t i = 0; i < population_size_; ++i)
+    {
+        MemberRef<T> member = generation[i];
+        std::construct_at(slot + i, member.fitness, member.value);
+    }
+
+    if (index >= stored_.size())
+        stored_.resize(index + 1, false);
+    if (!stored_[index])
+        ++num_stored_;
+    stored_[index] = true;
+}
+
+template <typename T>
+bool GenerationStore<T>::contains(std::size_t index) const
+{
+    return index < stored_.size() && stored_[index];
+}
+
+template <typename T>
+std::span<const Member<T>> GenerationStore<T>::operator[](std::size_t index) const
+{
+    if (!contains(index))
+        throw std::out_of_range("Generation " + std::to_string(index) + " is not stored");
+
+    return {mapping_ + index * population_size_, population_size_};
+}
+
+template <typename T>
+std::size_t GenerationStore<T>::numStored() const
+{
+    return num_stored_;
+}
+
+template <typename T>
+std::size_t GenerationStore<T>::fileSize() const
+{
+    return capacity_ * population_size_ * sizeof(Member<T>);
+}
+
+template <typename T>
+const std::filesystem::path& GenerationStore<T>::path() const
+{
+    return path_;
+}
+
+}
\ No newline at end of file
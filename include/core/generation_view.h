@@ -0,0 +1,39 @@
+#ifndef GENERATION_VIEW_H
+#define GENERATION_VIEW_H
+
+#include "member.h"
+#include "generation.h"
+#include <span>
+#include <vector>
+
+namespace genetic 
+{
+
+// Read-only view of a generation's members, in no particular order, whether they
+// are held in memory by a Generation or mapped from disk by a GenerationStore.
+// Like an iterator, it is invalidated when its history receives a new generation.
+template <typename T>
+class GenerationView
+{
+    private:
+        const Generation<T>* generation_;
+        std::span<const Member<T>> members_;
+
+    public:
+        GenerationView(const Generation<T>& generation);
+        GenerationView(std::span<const Member<T>> members);
+
+        MemberRef<T> operator[](std::size_t index) const;
+        std::vector<Member<T>> members() const; // Sorted by fitness
+        std::size_t size() const;
+        MemberRef<T> fittest() const;
+        float fittestScore() const;
+        float lowestScore() const;
+        float totalFitness() const;
+        GenerationStats stats() const;
+};
+
+}
+
+#include "generation_view.tpp"
+#endif
\ No newline at end of file
@@ -0,0 +1,102 @@
+#include "generation_view.h"
+#include <algorithm>
+
+namespace genetic 
+{
+
+template <typename T>
+GenerationView<T>::GenerationView(const Generation<T>& generation)
+    : generation_(&generation)
+{ }
+
+template <typename T>
+GenerationView<T>::GenerationView(std::span<const Member<T>> members)
+    : generation_(nullptr)
+    , members_(members)
+{ }
+
+template <typename T>
+MemberRef<T> GenerationView<T>::operator[](std::size_t index) const
+{
+    if (generation_)
+        return (*generation_)[index];
+
+    return {members_[index].fitness, members_[index].value};
+}
+
+template <typename T>
+std::vector<Member<T>> GenerationView<T>::members() const
+{
+    if (generation_)
+        return generation_->members();
+
+    std::vector<Member<T>> members (members_.begin(), members_.end());
+    std::stable_sort(members.begin(), members.end());
+    return members;
+}
+
+template <typename T>
+std::size_t GenerationView<T>::size() const
+{
+    return generation_ ? generation_->size() : members_.size();
+}
+
+template <typename T>
+MemberRef<T> GenerationView<T>::fittest() const
+{
+    if (generation_)
+        return generation_->fittest();
+
+    // Members are stored in the order the Generation held them, so the last of equals is its fittest
+    std::size_t fittest = 0;
+    for (std::size_t i = 1; i < members_.size(); ++i)
+    {
+        if (members_[i].fitness >= members_[fittest].fitness)
+            fittest = i;
+    }
+    return {members_[fittest].fitness, members_[fittest].value};
+}
+
+template <typename T>
+float GenerationView<T>::fittestScore() const
+{
+    return fittest().fitness;
+}
+
+template <typename T>
+float GenerationView<T>::lowestScore() const
+{
+    if (generation_)
+        return generation_->lowestScore();
+
+    return std::min_element(members_.begin(), members_.end())->fitness;
+}
+
+template <typename T>
+float GenerationView<T>::totalFitness() const
+{
+    if (generation_)
+        return generation_->totalFitness();
+
+    float total = 0.f;
+    for (const Member<T>& member : members_)
+    {
+        total += member.fitness;
+    }
+    return total;
+}
+
+template <typename T>
+GenerationStats GenerationView<T>::stats() const
+{
+    if (generation_)
+        return generation_->stats();
+
+    std::vector<float> fitness (members_.size());
+    for (std::size_t i = 0; i < members_.size(); ++i)
+        fitness[i] = members_[i].fitness;
+    std::vector<float> scratch;
+    return GenerationStats::of(fitness, totalFitness(), scratch);
+}
+
+}
\ No newline at end of file
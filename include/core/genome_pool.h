@@ -0,0 +1,39 @@
+#ifndef GENOME_POOL_H
+#define GENOME_POOL_H
+
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+namespace genetic 
+{
+
+using GenomeHandle = uint32_t;
+
+// Reference-counted genome storage shared by the generations of a population.
+// Generations hold handles, so a genome kept by several generations (e.g. an
+// elite) is stored once, and the slots of released genomes are reused.
+// Genomes never move in memory, so references stay valid as the pool grows.
+template <typename T>
+class GenomePool
+{
+    private:
+        std::deque<T> genomes_;
+        std::vector<uint32_t> references_;
+        std::vector<GenomeHandle> free_;
+
+    public:
+        GenomeHandle insert(T&& genome);
+        void retain(GenomeHandle handle);
+        void release(GenomeHandle handle);
+
+        const T& operator[](GenomeHandle handle) const;
+        std::size_t size() const;
+        std::size_t capacity() const;
+        std::size_t memoryUsage() const;
+};
+
+}
+
+#include "genome_pool.tpp"
+#endif
\ No newline at end of file
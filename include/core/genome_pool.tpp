@@ -0,0 +1,62 @@
+#include "genome_pool.h"
+
+namespace genetic 
+{
+
+template <typename T>
+GenomeHandle GenomePool<T>::insert(T&& genome)
+{
+    if (!free_.empty())
+    {
+        GenomeHandle handle = free_.back();
+        free_.pop_back();
+        genomes_[handle] = std::move(genome);
+        references_[handle] = 1;
+        return handle;
+    }
+
+    genomes_.push_back(std::move(genome));
+    references_.push_back(1);
+    return static_cast<GenomeHandle>(genomes_.size() - 1);
+}
+
+template <typename T>
+void GenomePool<T>::retain(GenomeHandle handle)
+{
+    ++references_[handle];
+}
+
+template <typename T>
+void GenomePool<T>::release(GenomeHandle handle)
+{
+    if (--references_[handle] == 0)
+        free_.push_back(handle);
+}
+
+template <typename T>
+const T& GenomePool<T>::operator[](GenomeHandle handle) const
+{
+    return genomes_[handle];
+}
+
+template <typename T>
+std::size_t GenomePool<T>::size() const
+{
+    return genomes_.size() - free_.size();
+}
+
+template <typename T>
+std::size_t GenomePool<T>::capacity() const
+{
+    return genomes_.size();
+}
+
+template <typename T>
+std::size_t GenomePool<T>::memoryUsage() const
+{
+    return genomes_.size() * sizeof(T)
+        + references_.capacity() * sizeof(uint32_t)
+        + free_.capacity() * sizeof(GenomeHandle);
+}
+
+}
\ No newline at end of file
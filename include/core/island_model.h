@@ -0,0 +1,144 @@
+#ifndef ISLAND_MODEL_H
+#define ISLAND_MODEL_H
+
+#include "ga.h"
+#include "member.h"
+#include "population_history.h"
+#include "serialization/serializer.h"
+#include "utils/mailbox.h"
+#include "utils/rng.h"
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace genetic
+{
+
+enum class Topology {Ring, Random, FullyConnected};
+
+// Runs several independent GeneticAlgorithms ("islands"), each on its own
+// thread. One evolve() call runs migration_interval generations on every
+// island, so a Controller's generation counts are migration intervals here.
+// At the end of each interval, an island posts copies of its fittest members
+// to its neighbours' mailboxes, tagged with its index and the interval. It then
+// waits only for the migrants its topology sends it for that interval and takes
+// them in order of source island. Islands never wait for the others as a group,
+// so a fast island can run one interval ahead of the last evolve() call, and a
+// seed gives the same run however the islands are scheduled. Methods that touch
+// the islands first wait for them to finish the interval they are running.
+// Each generation of the merged population history holds every island's
+// members at the end of one interval.
+template <typename T>
+class IslandModel
+{
+    private:
+        using Migrants = std::vector<Member<T>>;
+
+        struct Message
+        {
+            std::size_t source;
+            std::size_t interval;
+            Migrants migrants;
+        };
+
+        // An island's members at the end of an interval, for the merged history
+        struct Snapshot
+        {
+            std::vector<Member<T>> members;
+            std::exception_ptr error;
+        };
+
+        // Everything the island threads use, so that it stays put when the model is moved
+        struct Shared
+        {
+            std::vector<GeneticAlgorithm<T>> islands;
+            std::vector<std::unique_ptr<util::Mailbox<Message>>> mailboxes;
+            std::vector<std::vector<Message>> held; // Collected early, for an interval not yet reached
+
+            Topology topology;
+            std::size_t migration_interval;
+            std::size_t num_migrants;
+            uint32_t id; // Keys the random topology's draws
+
+            std::mutex mutex;
+            std::condition_variable changed;
+            std::size_t permitted; // Intervals since the restart that the islands may complete
+            std::vector<std::size_t> completed;
+            std::vector<std::deque<Snapshot>> snapshots;
+
+            // Run once by every island thread while the islands are idle
+            std::function<void(std::size_t)> command;
+            std::size_t command_epoch;
+            std::size_t commands_running;
+            std::exception_ptr command_error;
+
+            bool stopping;
+        };
+
+        std::unique_ptr<Shared> shared_;
+        std::size_t requested_; // Intervals asked for by evolve() since the restart
+
+        PopulationHistory<T> population_;
+
+        util::RNG rng_;
+
+        std::vector<std::thread> threads_;
+
+        static std::vector<std::size_t> destinations(const Shared& shared, std::size_t island, std::size_t interval);
+        static void run(Shared& shared, std::size_t island);
+        static Snapshot runInterval(Shared& shared, std::size_t island, std::size_t interval);
+        void settle() const;
+        void forEachIsland(std::function<void(std::size_t)> fn);
+        void stop();
+        void merge();
+
+    public:
+        IslandModel(
+            std::function<GeneticAlgorithm<T>()> make_island,
+            std::size_t num_islands,
+            Topology topology,
+            std::size_t migration_interval,
+            std::size_t num_migrants
+        );
+        IslandModel(IslandModel&& other) = default;
+        ~IslandModel();
+
+        void restart();
+        void restart(uint32_t id);
+        void evolve();
+
+        std::size_t numIslands() const;
+
+        // Valid until the next evolve() call
+        const GeneticAlgorithm<T>& island(std::size_t i) const;
+
+        // Applies to the merged history and to every island's own. Under
+        // Retention::Replay, the merged history keeps every n-th generation.
+        void setRetention(Retention retention, std::size_t n = 1);
+
+        // Spills the merged history only
+        void spillTo(const std::filesystem::path& path);
+
+        const std::string& getProblem() const;
+        const PopulationHistory<T>& getPopulation() const;
+
+        // Expose serializer functionality
+        bool savePopulation();
+        bool loadPopulation(std::string id);
+        std::vector<std::string> getSaves() const;
+        bool deleteSave(const std::string& id) const;
+        bool deleteAllSaves() const;
+};
+
+}
+
+#include "island_model.tpp"
+#endif
@@ -0,0 +1,451 @@
+#include "island_model.h"
+#include <iostream>
+#include <iterator>
+#include <algorithm>
+#include <stdexcept>
+
+namespace genetic
+{
+
+template <typename T>
+IslandModel<T>::IslandModel(
+    std::function<GeneticAlgorithm<T>()> make_island,
+    std::size_t num_islands,
+    Topology topology,
+    std::size_t migration_interval,
+    std::size_t num_migrants
+)
+    : shared_(std::make_unique<Shared>())
+    , requested_(0)
+    , population_(0, 1)
+    , rng_()
+{
+    if (num_islands == 0)
+        throw std::invalid_argument("num_islands must be greater than 0");
+    if (migration_interval == 0)
+        throw std::invalid_argument("migration_interval must be greater than 0");
+
+    Shared& shared = *shared_;
+    shared.islands.reserve(num_islands);
+    for (std::size_t i = 0; i < num_islands; ++i)
+    {
+        shared.islands.push_back(make_island());
+        shared.mailboxes.push_back(std::make_unique<util::Mailbox<Message>>());
+    }
+    shared.held.resize(num_islands);
+
+    const std::size_t island_size = shared.islands[0].getPopulation().populationSize();
+    for (const GeneticAlgorithm<T>& island : shared.islands)
+    {
+        if (island.getPopulation().populationSize() != island_size)
+            throw std::invalid_argument("All islands must have the same population size");
+    }
+    if (num_migrants > island_size)
+        throw std::invalid_argument("num_migrants must not exceed the island population size");
+
+    shared.topology = topology;
+    shared.migration_interval = migration_interval;
+    shared.num_migrants = num_migrants;
+    shared.id = 0;
+    shared.permitted = 0;
+    shared.completed.assign(num_islands, 0);
+    shared.snapshots.resize(num_islands);
+    shared.command_epoch = 0;
+    shared.commands_running = 0;
+    shared.stopping = false;
+
+    population_.restart(0, island_size * num_islands);
+
+    for (std::size_t i = 0; i < num_islands; ++i)
+        threads_.emplace_back(&IslandModel::run, std::ref(shared), i);
+
+    try
+    {
+        restart();
+    }
+    catch (...)
+    {
+        stop();
+        throw;
+    }
+}
+
+template <typename T>
+IslandModel<T>::~IslandModel()
+{
+    // Moved-from models own no threads
+    if (shared_)
+        stop();
+}
+
+template <typename T>
+void IslandModel<T>::stop()
+{
+    // An island stopped mid-interval could leave a neighbour waiting for its migrants forever
+    settle();
+    {
+        std::lock_guard<std::mutex> lock (shared_->mutex);
+        shared_->stopping = true;
+    }
+    shared_->changed.notify_all();
+    for (std::thread& thread : threads_)
+        thread.join();
+    threads_.clear();
+}
+
+template <typename T>
+void IslandModel<T>::restart()
+{
+    restart(rng_.index(UINT32_MAX));
+}
+
+template <typename T>
+void IslandModel<T>::restart(uint32_t id)
+{
+    // Island ids are derived from the merged id so that restarts can be replayed
+    forEachIsland([&](std::size_t i)
+    {
+        shared_->islands[i].restart(util::RNG(id, i).index(UINT32_MAX));
+    });
+
+    {
+        std::lock_guard<std::mutex> lock (shared_->mutex);
+        shared_->id = id;
+    }
+    population_.restart(id, population_.populationSize());
+    merge();
+}
+
+template <typename T>
+void IslandModel<T>::evolve()
+{
+    Shared& shared = *shared_;
+    std::vector<Snapshot> snapshots;
+    {
+        std::unique_lock<std::mutex> lock (shared.mutex);
+
+        // Let the islands run one interval ahead, so that a fast one need not wait for the caller
+        ++requested_;
+        shared.permitted = requested_ + 1;
+        shared.changed.notify_all();
+
+        shared.changed.wait(lock, [&]
+        {
+            return std::none_of(shared.snapshots.begin(), shared.snapshots.end(), [](const std::deque<Snapshot>& queue) { return queue.empty(); });
+        });
+        for (std::deque<Snapshot>& queue : shared.snapshots)
+        {
+            snapshots.push_back(std::move(queue.front()));
+            queue.pop_front();
+        }
+    }
+
+    std::vector<Member<T>> merged;
+    merged.reserve(population_.populationSize());
+    for (Snapshot& snapshot : snapshots)
+    {
+        if (snapshot.error)
+            std::rethrow_exception(snapshot.error);
+
+        std::move(snapshot.members.begin(), snapshot.members.end(), std::back_inserter(merged));
+    }
+    population_.pushNext(std::move(merged));
+}
+
+template <typename T>
+std::vector<std::size_t> IslandModel<T>::destinations(const Shared& shared, std::size_t island, std::size_t interval)
+{
+    const std::size_t n = shared.islands.size();
+    if (n == 1)
+        return {};
+
+    switch (shared.topology)
+    {
+        case Topology::Ring:
+            return {(island + 1) % n};
+        case Topology::Random:
+        {
+            util::RNG rng (shared.id, (static_cast<uint64_t>(interval) << 32) | island);
+            return {(island + 1 + rng.index(n - 1)) % n};
+        }
+        case Topology::FullyConnected:
+        {
+            std::vector<std::size_t> all;
+            for (std::size_t i = 1; i < n; ++i)
+                all.push_back((island + i) % n);
+            return all;
+        }
+    }
+    return {};
+}
+
+template <typename T>
+void IslandModel<T>::run(Shared& shared, std::size_t island)
+{
+    std::size_t seen_epoch = 0;
+    std::unique_lock<std::mutex> lock (shared.mutex);
+    while (true)
+    {
+        shared.changed.wait(lock, [&]
+        {
+            return shared.stopping || shared.command_epoch != seen_epoch || shared.completed[island] < shared.permitted;
+        });
+        if (shared.stopping)
+            return;
+
+        if (shared.command_epoch != seen_epoch)
+        {
+            seen_epoch = shared.command_epoch;
+            lock.unlock();
+            std::exception_ptr error;
+            try
+            {
+                shared.command(island);
+            }
+            catch (...)
+            {
+                error = std::current_exception();
+            }
+            lock.lock();
+
+            if (error && !shared.command_error)
+                shared.command_error = error;
+            if (--shared.commands_running == 0)
+                shared.changed.notify_all();
+            continue;
+        }
+
+        const std::size_t interval = shared.completed[island];
+        lock.unlock();
+        Snapshot snapshot = runInterval(shared, island, interval);
+        lock.lock();
+
+        shared.snapshots[island].push_back(std::move(snapshot));
+        ++shared.completed[island];
+        shared.changed.notify_all();
+    }
+}
+
+template <typename T>
+typename IslandModel<T>::Snapshot IslandModel<T>::runInterval(Shared& shared, std::size_t island, std::size_t interval)
+{
+    GeneticAlgorithm<T>& ga = shared.islands[island];
+    Snapshot snapshot;
+    Migrants emigrants;
+    try
+    {
+        for (std::size_t g = 0; g < shared.migration_interval; ++g)
+            ga.evolve();
+
+        // Send copies of this island's fittest members
+        const Generation<T>& current = ga.getPopulation().current();
+        std::vector<uint32_t> fittest;
+        current.fittestIndices(shared.num_migrants, fittest);
+        emigrants.reserve(fittest.size());
+        for (uint32_t i : fittest)
+        {
+            emigrants.push_back(current[i]);
+        }
+    }
+    catch (...)
+    {
+        // Still take part in the exchange, so that no neighbour waits forever
+        snapshot.error = std::current_exception();
+    }
+
+    for (std::size_t destination : destinations(shared, island, interval))
+    {
+        shared.mailboxes[destination]->post(Message{island, interval, emigrants});
+    }
+
+    // Wait only for the islands that send here this interval
+    std::size_t expected = 0;
+    for (std::size_t source = 0; source < shared.islands.size(); ++source)
+    {
+        std::vector<std::size_t> sent = destinations(shared, source, interval);
+        expected += std::count(sent.begin(), sent.end(), island);
+    }
+
+    std::vector<Message>& held = shared.held[island];
+    auto arrived = [&]
+    {
+        return static_cast<std::size_t>(std::count_if(held.begin(), held.end(), [&](const Message& message) { return message.interval == interval; }));
+    };
+    while (arrived() < expected)
+    {
+        shared.mailboxes[island]->wait();
+        for (Message& message : shared.mailboxes[island]->collect())
+            held.push_back(std::move(message));
+    }
+
+    // Neighbours running ahead may already have sent their next interval's migrants
+    auto ready = std::stable_partition(held.begin(), held.end(), [&](const Message& message) { return message.interval != interval; });
+    std::sort(ready, held.end(), [](const Message& a, const Message& b) { return a.source < b.source; });
+    Migrants immigrants;
+    for (auto it = ready; it != held.end(); ++it)
+    {
+        for (Member<T>& member : it->migrants)
+            immigrants.push_back(std::move(member));
+    }
+    held.erase(ready, held.end());
+    ga.immigrate(std::move(immigrants));
+
+    snapshot.members = ga.getPopulation().current().members();
+    return snapshot;
+}
+
+template <typename T>
+void IslandModel<T>::settle() const
+{
+    Shared& shared = *shared_;
+    std::unique_lock<std::mutex> lock (shared.mutex);
+    shared.changed.wait(lock, [&]
+    {
+        return std::all_of(shared.completed.begin(), shared.completed.end(), [&](std::size_t c) { return c == shared.permitted; });
+    });
+}
+
+template <typename T>
+void IslandModel<T>::forEachIsland(std::function<void(std::size_t)> fn)
+{
+    Shared& shared = *shared_;
+    settle();
+
+    std::unique_lock<std::mutex> lock (shared.mutex);
+    shared.command = std::move(fn);
+    shared.command_error = nullptr;
+    shared.commands_running = shared.islands.size();
+    ++shared.command_epoch;
+    shared.changed.notify_all();
+    shared.changed.wait(lock, [&]{ return shared.commands_running == 0; });
+    shared.command = nullptr;
+
+    // Whatever the command did, the islands start over from their current generation
+    std::fill(shared.completed.begin(), shared.completed.end(), 0);
+    shared.permitted = 0;
+    requested_ = 0;
+    for (std::size_t i = 0; i < shared.islands.size(); ++i)
+    {
+        shared.snapshots[i].clear();
+        shared.held[i].clear();
+        shared.mailboxes[i]->collect();
+    }
+
+    if (shared.command_error)
+        std::rethrow_exception(shared.command_error);
+}
+
+template <typename T>
+void IslandModel<T>::merge()
+{
+    std::vector<Member<T>> merged;
+    merged.reserve(population_.populationSize());
+    for (const GeneticAlgorithm<T>& island : shared_->islands)
+    {
+        std::vector<Member<T>> members = island.getPopulation().current().members();
+        std::move(members.begin(), members.end(), std::back_inserter(merged));
+    }
+
+    population_.pushNext(std::move(merged));
+}
+
+template <typename T>
+std::size_t IslandModel<T>::numIslands() const
+{
+    return shared_->islands.size();
+}
+
+template <typename T>
+const GeneticAlgorithm<T>& IslandModel<T>::island(std::size_t i) const
+{
+    settle();
+    return shared_->islands.at(i);
+}
+
+template <typename T>
+void IslandModel<T>::setRetention(Retention retention, std::size_t n)
+{
+    // Islands can replay their own generations, but the merged history is not bred
+    population_.setRetention(retention == Retention::Replay ? Retention::EveryNth : retention, n);
+    settle();
+    for (GeneticAlgorithm<T>& island : shared_->islands)
+        island.setRetention(retention, n);
+}
+
+template <typename T>
+void IslandModel<T>::spillTo(const std::filesystem::path& path)
+{
+    population_.spillTo(path);
+}
+
+template <typename T>
+const std::string& IslandModel<T>::getProblem() const
+{
+    return shared_->islands[0].getProblem();
+}
+
+template <typename T>
+const PopulationHistory<T>& IslandModel<T>::getPopulation() const
+{
+    return population_;
+}
+
+template <typename T>
+bool IslandModel<T>::savePopulation()
+{
+    return shared_->islands[0].getSerializer().save(population_);
+}
+
+template <typename T>
+bool IslandModel<T>::loadPopulation(std::string id)
+{
+    std::optional<PopulationHistory<T>> data = shared_->islands[0].getSerializer().load(id);
+
+    if (!data.has_value())
+        return false;
+
+    if (data.value().populationSize() != population_.populationSize())
+    {
+        std::cerr << "Population " << id << " has " << data.value().populationSize()
+            << " members, but the islands hold " << population_.populationSize() << "\n";
+        return false;
+    }
+
+    population_.load(std::move(data.value()));
+
+    // Deal the loaded members out so that every island receives a spread of fitness
+    const Generation<T>& current = population_.current();
+    const std::size_t num_islands = shared_->islands.size();
+    forEachIsland([&](std::size_t i)
+    {
+        std::vector<Member<T>> founders;
+        for (std::size_t j = i; j < current.size(); j += num_islands)
+            founders.push_back(current[j]);
+
+        shared_->islands[i].restart(util::RNG(population_.id(), i).index(UINT32_MAX), std::move(founders));
+    });
+
+    std::lock_guard<std::mutex> lock (shared_->mutex);
+    shared_->id = population_.id();
+    return true;
+}
+
+template <typename T>
+std::vector<std::string> IslandModel<T>::getSaves() const
+{
+    return shared_->islands[0].getSaves();
+}
+
+template <typename T>
+bool IslandModel<T>::deleteSave(const std::string& id) const
+{
+    return shared_->islands[0].deleteSave(id);
+}
+
+template <typename T>
+bool IslandModel<T>::deleteAllSaves() const
+{
+    return shared_->islands[0].deleteAllSaves();
+}
+
+}
@@ -21,6 +21,18 @@ struct Member
     }
 };
 
+// Member whose genome is stored elsewhere, e.g. in a GenomePool
+template <typename T>
+struct MemberRef
+{
+    float fitness;
+    const T& value;
+
+    operator Member<T>() const {
+        return {fitness, value};
+    }
+};
+
 }
 
 #endif
\ No newline at end of file
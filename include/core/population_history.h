@@ -4,13 +4,31 @@
 #include "serialization/serializer.h"
 #include "member.h"
 #include "generation.h"
+#include "generation_store.h"
+#include "generation_view.h"
+#include "generation_stats.h"
+#include "genome_pool.h"
+#include <filesystem>
 #include <string>
 #include <vector>
 #include <cstdint>
+#include <memory>
+#include <optional>
 
 namespace genetic 
 {
 
+// Which past generations a PopulationHistory keeps. The current generation is
+// always kept, and every generation's statistics are kept regardless.
+//  All:         every generation
+//  Last:        the last n generations
+//  EveryNth:    generations whose number is a multiple of n
+//  SummaryOnly: no past generations, nor the fittest member of each
+//  Replay:      checkpoints every n generations, plus those marked by checkpoint().
+//               The others are bred again from the nearest checkpoint when viewed,
+//               see StaticGeneticAlgorithm::generation.
+enum class Retention {All, Last, EveryNth, SummaryOnly, Replay};
+
 template <typename T>
 class PopulationHistory {
     friend class Serializer<T>;
@@ -18,8 +36,31 @@ class PopulationHistory {
     private:
         uint32_t id_;
         std::size_t population_size_;
+        std::shared_ptr<GenomePool<T>> pool_;
+
+        // Retained generations in order, the last being the current one
         std::vector<Generation<T>> generations_;
-        std::vector<Member<T>> fittest_history_;
+        std::vector<std::size_t> indices_;
+        std::size_t num_generations_;
+
+        std::vector<GenerationStats> stats_; // One per generation
+
+        // Consecutive generations sharing their fittest genome share one copy of it
+        static constexpr uint32_t NOT_RECORDED = UINT32_MAX;
+        std::vector<T> fittest_genomes_;
+        std::vector<uint32_t> fittest_indices_; // One per generation
+
+        Retention retention_;
+        std::size_t retention_n_;
+
+        // Generations that cannot be bred again from their parent, kept under Replay
+        std::vector<std::size_t> checkpoints_;
+
+        // Receives every generation when spilling to disk; shared by copies of this history
+        std::shared_ptr<GenerationStore<T>> store_;
+
+        bool retains(std::size_t i, std::size_t current) const;
+        void record(std::optional<GenomeHandle> previous_fittest);
 
     public:
         PopulationHistory(uint32_t id, std::size_t population_size);
@@ -27,12 +68,49 @@ class PopulationHistory {
         std::string formattedId() const;
         std::size_t populationSize() const;
         std::size_t numGenerations() const;
-        const Generation<T>& generation(std::size_t i) const;
+        bool isRetained(std::size_t i) const; // In memory or on disk
+        const std::vector<std::size_t>& retainedGenerations() const; // In memory
+        GenerationView<T> generation(std::size_t i) const;
+        const Generation<T>& retained(std::size_t i) const; // Retained in memory
         const Generation<T>& current() const;
-        const std::vector<Member<T>>& fittestHistory() const;
+        const std::vector<GenerationStats>& stats() const;
+        std::vector<Member<T>> fittestHistory() const;
+        const std::shared_ptr<GenomePool<T>>& pool() const;
         void pushNext(std::vector<Member<T>>&& next);
+        void pushNext(Generation<T>&& next);
+
+        // Takes over the entries' pool references. When the replaced generation
+        // is not retained, the entries are copied into its arrays. `next` is
+        // emptied either way but keeps its capacity, so it can be refilled
+        // without allocating.
+        void pushNext(std::vector<Member<GenomeHandle>>& next);
+
+        // Keep the current generation under Retention::Replay, because it
+        // cannot be bred again from its parent, e.g. it received immigrants
+        void checkpoint();
+
+        // Whether generation i can be bred again from a retained generation before it
+        bool isReplayable(std::size_t i) const;
+
         void restart(uint32_t new_id, std::size_t new_size);
 
+        // Take over another history's generations, keeping this one's retention and spill settings
+        void load(PopulationHistory<T>&& other);
+
+        // Write every generation, including those already retained, to a memory-mapped
+        // file at path, so that generation(i) can still view those not kept in memory
+        void spillTo(const std::filesystem::path& path);
+        void stopSpilling();
+        const GenerationStore<T>* spillStore() const;
+
+        // Generations the new policy does not retain are dropped immediately
+        void setRetention(Retention retention, std::size_t n = 1);
+        Retention retention() const;
+        std::size_t retentionN() const;
+
+        // Approximate bytes held by retained generations, statistics and the genome pool
+        std::size_t memoryUsage() const;
+
         float currentFittestScore() const;
 };
 
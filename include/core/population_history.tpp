@@ -10,6 +10,10 @@ template <typename T>
 PopulationHistory<T>::PopulationHistory(uint32_t id, std::size_t population_size)
     : id_(id)
     , population_size_(population_size)
+    , pool_(std::make_shared<GenomePool<T>>())
+    , num_generations_(0)
+    , retention_(Retention::All)
+    , retention_n_(1)
 {
     if (population_size == 0)
         throw std::invalid_argument("Population size must be greater than 0");
@@ -36,13 +40,41 @@ std::size_t PopulationHistory<T>::populationSize() const
 template <typename T>
 std::size_t PopulationHistory<T>::numGenerations() const
 {
-    return generations_.size();
+    return num_generations_;
 }
 
 template <typename T>
-const Generation<T>& PopulationHistory<T>::generation(std::size_t i) const
+bool PopulationHistory<T>::isRetained(std::size_t i) const
 {
-    return generations_[i];
+    return std::binary_search(indices_.begin(), indices_.end(), i) || (store_ && store_->contains(i));
+}
+
+template <typename T>
+const std::vector<std::size_t>& PopulationHistory<T>::retainedGenerations() const
+{
+    return indices_;
+}
+
+template <typename T>
+GenerationView<T> PopulationHistory<T>::generation(std::size_t i) const
+{
+    auto it = std::lower_bound(indices_.begin(), indices_.end(), i);
+    if (it != indices_.end() && *it == i)
+        return generations_[it - indices_.begin()];
+    if (store_ && store_->contains(i))
+        return (*store_)[i];
+
+    throw std::out_of_range("Generation " + std::to_string(i) + " is not retained");
+}
+
+template <typename T>
+const Generation<T>& PopulationHistory<T>::retained(std::size_t i) const
+{
+    auto it = std::lower_bound(indices_.begin(), indices_.end(), i);
+    if (it == indices_.end() || *it != i)
+        throw std::out_of_range("Generation " + std::to_string(i) + " is not retained in memory");
+
+    return generations_[it - indices_.begin()];
 }
 
 template <typename T>
@@ -55,9 +87,50 @@ const Generation<T>& PopulationHistory<T>::current() const
 }
 
 template <typename T>
-const std::vector<Member<T>>& PopulationHistory<T>::fittestHistory() const
+const std::vector<GenerationStats>& PopulationHistory<T>::stats() const
 {
-    return fittest_history_;
+    return stats_;
+}
+
+template <typename T>
+std::vector<Member<T>> PopulationHistory<T>::fittestHistory() const
+{
+    std::vector<Member<T>> history;
+    history.reserve(fittest_indices_.size());
+    for (std::size_t i = 0; i < fittest_indices_.size(); ++i)
+    {
+        if (fittest_indices_[i] != NOT_RECORDED)
+            history.emplace_back(stats_[i].fittest_score, fittest_genomes_[fittest_indices_[i]]);
+    }
+    return history;
+}
+
+template <typename T>
+const std::shared_ptr<GenomePool<T>>& PopulationHistory<T>::pool() const
+{
+    return pool_;
+}
+
+template <typename T>
+bool PopulationHistory<T>::retains(std::size_t i, std::size_t current) const
+{
+    if (i == current)
+        return true;
+
+    switch (retention_)
+    {
+        case Retention::All:
+            return true;
+        case Retention::Last:
+            return current - i < retention_n_;
+        case Retention::EveryNth:
+            return i % retention_n_ == 0;
+        case Retention::SummaryOnly:
+            return false;
+        case Retention::Replay:
+            return i % retention_n_ == 0 || std::binary_search(checkpoints_.begin(), checkpoints_.end(), i);
+    }
+    return true;
 }
 
 template <typename T>
@@ -67,8 +140,102 @@ void PopulationHistory<T>::pushNext(std::vector<Member<T>>&& next)
         throw std::invalid_argument("Size " + std::to_string(next.size()) + "of next generation conflicts with size "
         + std::to_string(population_size_) + " of population history");   
     
-    generations_.emplace_back(std::move(next));
-    fittest_history_.push_back(generations_.back().fittest());
+    pushNext(Generation<T>(pool_, std::move(next)));
+}
+
+template <typename T>
+void PopulationHistory<T>::pushNext(Generation<T>&& next)
+{
+    if (next.size() != population_size_)
+        throw std::invalid_argument("Size " + std::to_string(next.size()) + "of next generation conflicts with size "
+        + std::to_string(population_size_) + " of population history");   
+    if (next.pool() != pool_)
+        throw std::invalid_argument("Next generation must store its genomes in the population history's pool");
+
+    std::optional<GenomeHandle> previous_fittest;
+    if (!generations_.empty())
+        previous_fittest = generations_.back().entry(generations_.back().fittestIndex()).value;
+
+    if (!generations_.empty() && !retains(indices_.back(), num_generations_))
+    {
+        generations_.back() = std::move(next);
+        indices_.back() = num_generations_;
+    }
+    else
+    {
+        generations_.push_back(std::move(next));
+        indices_.push_back(num_generations_);
+    }
+    record(previous_fittest);
+}
+
+template <typename T>
+void PopulationHistory<T>::pushNext(std::vector<Member<GenomeHandle>>& next)
+{
+    if (next.size() != population_size_)
+        throw std::invalid_argument("Size " + std::to_string(next.size()) + "of next generation conflicts with size "
+        + std::to_string(population_size_) + " of population history");   
+
+    if (generations_.empty() || retains(indices_.back(), num_generations_))
+    {
+        pushNext(Generation<T>(pool_, std::move(next)));
+        next.clear();
+        return;
+    }
+
+    // Copy into the replaced generation's arrays; the caller's vector keeps its capacity
+    std::optional<GenomeHandle> previous_fittest = generations_.back().entry(generations_.back().fittestIndex()).value;
+    generations_.back().replaceAll(next);
+    indices_.back() = num_generations_;
+    record(previous_fittest);
+}
+
+template <typename T>
+void PopulationHistory<T>::checkpoint()
+{
+    if (num_generations_ == 0)
+        throw std::logic_error("Cannot checkpoint a current generation that does not exist");
+
+    if (checkpoints_.empty() || checkpoints_.back() != num_generations_ - 1)
+        checkpoints_.push_back(num_generations_ - 1);
+}
+
+template <typename T>
+bool PopulationHistory<T>::isReplayable(std::size_t i) const
+{
+    return retention_ == Retention::Replay && i < num_generations_ && !indices_.empty() && indices_.front() < i;
+}
+
+template <typename T>
+void PopulationHistory<T>::record(std::optional<GenomeHandle> previous_fittest)
+{
+    const Generation<T>& current = generations_.back();
+    stats_.push_back(current.stats());
+
+    // Handles of the previous generation are still referenced while the next
+    // one is built, so an equal handle means the same genome was carried over
+    uint32_t fittest_index = NOT_RECORDED;
+    if (retention_ != Retention::SummaryOnly)
+    {
+        const GenomeHandle fittest = current.entry(current.fittestIndex()).value;
+        const bool carried_over = previous_fittest == fittest
+            && !fittest_indices_.empty() && fittest_indices_.back() != NOT_RECORDED;
+        if (!carried_over)
+            fittest_genomes_.push_back((*pool_)[fittest]);
+        fittest_index = static_cast<uint32_t>(fittest_genomes_.size() - 1);
+    }
+    fittest_indices_.push_back(fittest_index);
+
+    if (store_)
+        store_->write(num_generations_, current);
+    ++num_generations_;
+
+    // Under Last, the oldest generation falls out as each new one arrives
+    while (generations_.size() > 1 && !retains(indices_.front(), indices_.back()))
+    {
+        generations_.erase(generations_.begin());
+        indices_.erase(indices_.begin());
+    }
 }
 
 template <typename T>
@@ -77,6 +244,131 @@ void PopulationHistory<T>::restart(uint32_t new_id, std::size_t new_size)
     id_ = new_id;
     population_size_ = new_size;
     generations_.clear();
+    indices_.clear();
+    num_generations_ = 0;
+    stats_.clear();
+    fittest_genomes_.clear();
+    fittest_indices_.clear();
+    checkpoints_.clear();
+
+    if (store_)
+    {
+        // Release the old store first, since the new one truncates the same file
+        std::filesystem::path spill_path = store_->path();
+        store_.reset();
+        store_ = std::make_shared<GenerationStore<T>>(spill_path, population_size_);
+    }
+}
+
+template <typename T>
+void PopulationHistory<T>::load(PopulationHistory<T>&& other)
+{
+    const Retention retention = retention_;
+    const std::size_t retention_n = retention_n_;
+    std::optional<std::filesystem::path> spill_path;
+    if (store_)
+        spill_path = store_->path();
+
+    // Release the old store first, since the new one truncates the same file
+    store_.reset();
+    *this = std::move(other);
+
+    // Which loaded generations could be bred again is unknown, so all of them are kept
+    checkpoints_ = indices_;
+
+    setRetention(retention, retention_n);
+    if (spill_path.has_value())
+        spillTo(spill_path.value());
+    else
+        stopSpilling();
+}
+
+template <typename T>
+void PopulationHistory<T>::spillTo(const std::filesystem::path& path)
+{
+    store_.reset();
+    store_ = std::make_shared<GenerationStore<T>>(path, population_size_);
+    for (std::size_t i = 0; i < generations_.size(); ++i)
+    {
+        store_->write(indices_[i], generations_[i]);
+    }
+}
+
+template <typename T>
+void PopulationHistory<T>::stopSpilling()
+{
+    store_.reset();
+}
+
+template <typename T>
+const GenerationStore<T>* PopulationHistory<T>::spillStore() const
+{
+    return store_.get();
+}
+
+template <typename T>
+void PopulationHistory<T>::setRetention(Retention retention, std::size_t n)
+{
+    if ((retention == Retention::Last || retention == Retention::EveryNth || retention == Retention::Replay) && n == 0)
+        throw std::invalid_argument("Retention interval must be greater than 0");
+
+    retention_ = retention;
+    retention_n_ = n;
+
+    if (generations_.empty())
+        return;
+
+    const std::size_t current = indices_.back();
+    std::size_t kept = 0;
+    for (std::size_t i = 0; i < generations_.size(); ++i)
+    {
+        if (!retains(indices_[i], current))
+            continue;
+
+        if (i != kept)
+        {
+            generations_[kept] = std::move(generations_[i]);
+            indices_[kept] = indices_[i];
+        }
+        ++kept;
+    }
+    generations_.erase(generations_.begin() + kept, generations_.end());
+    indices_.erase(indices_.begin() + kept, indices_.end());
+
+    if (retention_ == Retention::SummaryOnly)
+    {
+        fittest_genomes_.clear();
+        fittest_genomes_.shrink_to_fit();
+        std::fill(fittest_indices_.begin(), fittest_indices_.end(), NOT_RECORDED);
+    }
+}
+
+template <typename T>
+Retention PopulationHistory<T>::retention() const
+{
+    return retention_;
+}
+
+template <typename T>
+std::size_t PopulationHistory<T>::retentionN() const
+{
+    return retention_n_;
+}
+
+template <typename T>
+std::size_t PopulationHistory<T>::memoryUsage() const
+{
+    std::size_t bytes = pool_->memoryUsage();
+    for (const Generation<T>& generation : generations_)
+    {
+        bytes += generation.memoryUsage();
+    }
+    bytes += indices_.capacity() * sizeof(std::size_t);
+    bytes += stats_.capacity() * sizeof(GenerationStats);
+    bytes += fittest_genomes_.capacity() * sizeof(T);
+    bytes += fittest_indices_.capacity() * sizeof(uint32_t);
+    bytes += checkpoints_.capacity() * sizeof(std::size_t);
+    return bytes;
 }
 
 template <typename T>
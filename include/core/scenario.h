@@ -4,21 +4,100 @@
 #include "serialization/serializer.h"
 #include "utils/rng.h"
 #include <string>
+#include <span>
+#include <memory>
+#include <concepts>
+#include <array>
+#include <cstdint>
 
 namespace genetic
 {
 
+// Describes what a single mutation changed, so that the mutated genome's
+// fitness can be derived from its parent's. Its meaning is up to the scenario.
+struct MutationRecord
+{
+    std::array<uint32_t, 4> positions;
+    uint32_t count = 0;
+};
+
 template <typename T>
 class Scenario
 {
     public: 
+    using Genome = T;
+
+    virtual ~Scenario() = default;
+
     virtual const std::string& getName() = 0;
     virtual const Serializer<T>& getSerializer() = 0;
     
     virtual float evaluateFitness(const T&) = 0;
+    virtual void evaluateFitnessBatch(std::span<const T> genomes, std::span<float> fitness)
+    {
+        // Override to amortize setup or vectorize across a whole batch of genomes
+        for (std::size_t i = 0; i < genomes.size(); ++i)
+            fitness[i] = evaluateFitness(genomes[i]);
+    }
     virtual T birth(util::RNG&) = 0;
     virtual T crossover(const T&, const T&, util::RNG&) = 0;
     virtual void mutate(T&, util::RNG&) = 0;
+
+    // Override both to evaluate children produced by mutation alone incrementally.
+    // mutateRecorded mutates like mutate and returns whether it filled in the record.
+    virtual bool mutateRecorded(T& genome, util::RNG& rng, MutationRecord&)
+    {
+        mutate(genome, rng);
+        return false;
+    }
+    virtual float evaluateFitnessDelta(const T& genome, float /*parent_fitness*/, const MutationRecord&)
+    {
+        return evaluateFitness(genome);
+    }
+};
+
+// Operations a scenario must provide to drive a StaticGeneticAlgorithm.
+// Any class deriving from Scenario satisfies it.
+template <typename S>
+concept ScenarioType = requires(
+    S& scenario,
+    const typename S::Genome& genome,
+    typename S::Genome& offspring,
+    util::RNG& rng
+)
+{
+    { scenario.getName() } -> std::convertible_to<const std::string&>;
+    { scenario.getSerializer() } -> std::convertible_to<const Serializer<typename S::Genome>&>;
+    { scenario.evaluateFitness(genome) } -> std::convertible_to<float>;
+    { scenario.birth(rng) } -> std::same_as<typename S::Genome>;
+    { scenario.crossover(genome, genome, rng) } -> std::same_as<typename S::Genome>;
+    scenario.mutate(offspring, rng);
+};
+
+// Owns a runtime-polymorphic Scenario and forwards to it through virtual calls
+template <typename T>
+class PolymorphicScenario
+{
+    private:
+    std::unique_ptr<Scenario<T>> scenario_;
+
+    public:
+    using Genome = T;
+
+    explicit PolymorphicScenario(std::unique_ptr<Scenario<T>> scenario)
+    : scenario_(std::move(scenario))
+    { }
+
+    const std::string& getName() { return scenario_->getName(); }
+    const Serializer<T>& getSerializer() { return scenario_->getSerializer(); }
+
+    float evaluateFitness(const T& genome) { return scenario_->evaluateFitness(genome); }
+    void evaluateFitnessBatch(std::span<const T> genomes, std::span<float> fitness) { scenario_->evaluateFitnessBatch(genomes, fitness); }
+    T birth(util::RNG& rng) { return scenario_->birth(rng); }
+    T crossover(const T& a, const T& b, util::RNG& rng) { return scenario_->crossover(a, b, rng); }
+    void mutate(T& genome, util::RNG& rng) { scenario_->mutate(genome, rng); }
+    bool mutateRecorded(T& genome, util::RNG& rng, MutationRecord& record) { return scenario_->mutateRecorded(genome, rng, record); }
+    float evaluateFitnessDelta(const T& genome, float parent_fitness, const MutationRecord& record) { return scenario_->evaluateFitnessDelta(genome, parent_fitness, record); }
 };
 
 }
@@ -0,0 +1,166 @@
+#ifndef STATIC_GA_H
+#define STATIC_GA_H
+
+#include "scenario.h"
+#include "member.h"
+#include "population_history.h"
+#include "fitness_cache.h"
+#include "operator/selection.h"
+#include "serialization/serializer.h"
+#include "utils/rng.h"
+#include "utils/thread_pool.h"
+
+#include <optional>
+#include <vector>
+#include <span>
+#include <functional>
+#include <string>
+#include <filesystem>
+#include <type_traits>
+#include <memory>
+#include <cstdint>
+
+namespace genetic 
+{
+
+// Genetic algorithm whose scenario and selection are fixed at compile time, so
+// the whole breeding loop can be inlined. Selection is any callable taking
+// (const Generation<Genome>&, util::RNG&, std::span<uint32_t>) that fills the
+// span with the indices of the members chosen, like selection::Function.
+template <ScenarioType S, typename Selection>
+class StaticGeneticAlgorithm
+{
+    public:
+        using Genome = typename S::Genome;
+
+    private:
+        using T = Genome;
+
+        // Scenario operators are not const-qualified
+        mutable S scenario_;
+
+        const float elitism_rate_;
+
+        // Probability that a child is bred by crossover rather than by mutation alone
+        float crossover_rate_;
+
+        // The crossover rate in effect from each generation on, for replaying past generations
+        std::vector<std::pair<std::size_t, float>> crossover_rates_;
+
+        Selection selection_function_;
+
+        PopulationHistory<T> population_;
+
+        util::RNG rng_;
+
+        std::unique_ptr<util::ThreadPool> pool_;
+
+        // Steady-state mode is active while offspring_per_step_ > 0
+        std::size_t offspring_per_step_;
+        std::size_t steps_per_snapshot_;
+        std::optional<Generation<T>> working_;
+
+        // Fitness of recently evaluated genomes, if enabled
+        std::unique_ptr<FitnessCache<T>> cache_;
+
+        // Scratch buffers reused by every generation, so that evolving allocates nothing once they have grown
+        std::vector<Member<GenomeHandle>> next_;
+        std::vector<T> offspring_;
+        std::vector<float> fitness_;
+        std::vector<uint8_t> known_;
+        std::vector<std::pair<std::size_t, std::size_t>> swaps_;
+        std::vector<uint32_t> selected_; // Parent indices, two per child
+        std::vector<uint32_t> elite_indices_;
+
+        // Members received from elsewhere, e.g. other islands, awaiting the next evolve()
+        std::vector<Member<T>> immigrants_;
+
+        // The generation most recently bred again by generation(), if any
+        std::optional<Generation<T>> replayed_;
+        std::size_t replayed_index_;
+
+        // Offspring slots stay below this bit, so selection streams never collide with theirs
+        static constexpr std::size_t SELECTION_STREAM = std::size_t(1) << 31;
+
+        inline std::size_t numElites();
+        util::RNG slotRng(std::size_t generation, std::size_t slot) const;
+        template <typename F>
+        void forEachSlot(std::size_t begin, std::size_t end, F&& fn);
+        void evaluate(std::span<T> genomes, std::span<float> fitness, std::span<const uint8_t> known = {});
+        void evaluateUncached(std::span<const T> genomes, std::span<float> fitness);
+        void evaluateBatch(std::span<const T> genomes, std::span<float> fitness);
+        void breed(const Generation<T>& parents, std::size_t generation, float crossover_rate, std::size_t first_slot, std::span<T> offspring, std::span<float> fitness, std::span<uint8_t> known);
+        void appendElites(const Generation<T>& parents, std::vector<Member<GenomeHandle>>& next);
+        void appendOffspring(const Generation<T>& parents, std::size_t generation, float crossover_rate, std::vector<Member<GenomeHandle>>& next);
+        float crossoverRateAt(std::size_t generation) const;
+        void resizeBuffers(std::size_t num_offspring);
+        void evolveSteadyState();
+
+    public:
+        StaticGeneticAlgorithm(
+            S scenario,
+            Selection select,
+            std::size_t population_size,
+            float elitism_rate
+        );
+        void restart();
+        void restart(uint32_t id);
+        void restart(uint32_t id, std::vector<Member<T>>&& founders);
+        void evolve();
+
+        // Queue members to replace part of the next generation's offspring
+        void immigrate(std::vector<Member<T>>&& immigrants);
+
+        // Offspring are bred concurrently when num_threads > 1, in which case
+        // the scenario's operators must be safe to call from several threads.
+        // Results for a given population id do not depend on num_threads.
+        void setThreads(std::size_t num_threads);
+        std::size_t getThreads() const;
+
+        // In steady-state mode each evolve() call runs steps_per_snapshot steps,
+        // each replacing the offspring_per_step least fit members of a working
+        // population in place, then records a single snapshot of it. A snapshot
+        // holds fewer than 2^31 offspring, so that each has its own RNG stream.
+        void setSteadyState(std::size_t offspring_per_step, std::size_t steps_per_snapshot);
+        void setGenerational();
+
+        // Children not bred by crossover are mutated copies of one parent. When the
+        // scenario records its mutations, their fitness is evaluated incrementally.
+        void setCrossoverRate(float crossover_rate);
+        float getCrossoverRate() const;
+
+        // Which past generations to keep. When the generation being replaced is
+        // not kept, its storage is reused for the next one.
+        void setRetention(Retention retention, std::size_t n = 1);
+
+        // Also write every generation to a memory-mapped file, see PopulationHistory::spillTo
+        void spillTo(const std::filesystem::path& path);
+
+        // Reuse the fitness of genomes seen among the last `capacity` distinct
+        // evaluations instead of evaluating them again. Requires that fitness
+        // depends on nothing but the genome. A capacity of 0 disables the cache.
+        void setFitnessCache(std::size_t capacity, CachePolicy policy = CachePolicy::LRU);
+        const FitnessCache<T>* getFitnessCache() const;
+        
+        const std::string& getProblem() const;
+        const PopulationHistory<T>& getPopulation() const;
+
+        // View generation i. Under Retention::Replay, a generation that was not
+        // retained is bred again from the nearest one before it that was, which
+        // requires the scenario's operators to depend on nothing but their
+        // arguments. A bred generation stays valid until the next call to generation().
+        GenerationView<T> generation(std::size_t i);
+
+        // Expose serializer functionality
+        const Serializer<T>& getSerializer();
+        bool savePopulation();
+        bool loadPopulation(std::string id);
+        std::vector<std::string> getSaves() const;
+        bool deleteSave(const std::string& id) const;
+        bool deleteAllSaves() const;
+};
+
+}
+
+#include "static_ga.tpp"
+#endif
\ No newline at end of file
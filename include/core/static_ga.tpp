@@ -0,0 +1,584 @@
+#include "static_ga.h"
+#include <cassert>
+#include <algorithm>
+#include <ctime>
+
+namespace genetic 
+{
+
+template <ScenarioType S, typename Selection>
+StaticGeneticAlgorithm<S, Selection>::StaticGeneticAlgorithm(
+    S scenario,
+    Selection select,
+    std::size_t population_size,
+    float elitism_rate
+)
+    : scenario_(std::move(scenario))
+    , selection_function_(std::move(select))
+    , population_(0, population_size)
+    , elitism_rate_(elitism_rate)
+    , crossover_rate_(1.f)
+    , crossover_rates_{{0, 1.f}}
+    , rng_()
+    , offspring_per_step_(0)
+    , steps_per_snapshot_(1)
+{
+    if (!(elitism_rate_ >= 0.f && elitism_rate_ <= 1.f))
+        throw std::invalid_argument("elitism_rate must be in the interval [0, 1]");
+
+    restart();
+}
+
+template <ScenarioType S, typename Selection>
+void StaticGeneticAlgorithm<S, Selection>::restart()
+{
+    restart(rng_.index(UINT32_MAX));
+}
+
+template <ScenarioType S, typename Selection>
+void StaticGeneticAlgorithm<S, Selection>::restart(uint32_t id)
+{
+    std::size_t size = population_.populationSize();
+    population_.restart(id, size);
+    working_.reset();
+    immigrants_.clear();
+    replayed_.reset();
+    crossover_rates_.assign(1, {0, crossover_rate_});
+    
+    // Birth
+    std::vector<T> genomes (size);
+    forEachSlot(0, size, [&](std::size_t slot)
+    {
+        util::RNG rng = slotRng(0, slot);
+        genomes[slot] = scenario_.birth(rng);
+    });
+
+    // Evaluate
+    std::vector<float> fitness (size);
+    evaluate(genomes, fitness);
+
+    std::vector<Member<T>> next;
+    next.reserve(size);
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        next.emplace_back(fitness[i], std::move(genomes[i]));
+    }
+
+    population_.pushNext(std::move(next));
+}
+
+template <ScenarioType S, typename Selection>
+void StaticGeneticAlgorithm<S, Selection>::restart(uint32_t id, std::vector<Member<T>>&& founders)
+{
+    std::size_t size = population_.populationSize();
+    if (founders.size() != size)
+        throw std::invalid_argument("Number of founders must match the population size");
+
+    population_.restart(id, size);
+    working_.reset();
+    immigrants_.clear();
+    replayed_.reset();
+    crossover_rates_.assign(1, {0, crossover_rate_});
+
+    population_.pushNext(std::move(founders));
+}
+
+template <ScenarioType S, typename Selection>
+void StaticGeneticAlgorithm<S, Selection>::immigrate(std::vector<Member<T>>&& immigrants)
+{
+    for (Member<T>& immigrant : immigrants)
+        immigrants_.push_back(std::move(immigrant));
+}
+
+template <ScenarioType S, typename Selection>
+void StaticGeneticAlgorithm<S, Selection>::evolve()
+{
+    if (offspring_per_step_ > 0)
+    {
+        evolveSteadyState();
+        return;
+    }
+
+    const Generation<T>& parents = population_.current();
+    const std::size_t generation = population_.numGenerations();
+    GenomePool<T>& pool = *population_.pool();
+
+    next_.clear();
+    next_.reserve(population_.populationSize());
+    appendElites(parents, next_);
+
+    // Immigration
+    const std::size_t immigrants = std::min(immigrants_.size(), population_.populationSize() - next_.size());
+    for (std::size_t i = 0; i < immigrants; ++i)
+    {
+        next_.emplace_back(immigrants_[i].fitness, pool.insert(std::move(immigrants_[i].value)));
+    }
+    immigrants_.clear();
+
+    appendOffspring(parents, generation, crossover_rate_, next_);
+
+    // Finalize
+    population_.pushNext(next_);
+
+    // Immigrants cannot be bred again, so neither can this generation
+    if (immigrants > 0)
+        population_.checkpoint();
+}
+
+template <ScenarioType S, typename Selection>
+void StaticGeneticAlgorithm<S, Selection>::appendElites(const Generation<T>& parents, std::vector<Member<GenomeHandle>>& next)
+{
+    // Elites are shared with the previous generation rather than copied
+    GenomePool<T>& pool = *population_.pool();
+    parents.fittestIndices(numElites(), elite_indices_);
+    for (uint32_t i : elite_indices_)
+    {
+        const Member<GenomeHandle> elite = parents.entry(i);
+        pool.retain(elite.value);
+        next.push_back(elite);
+    }
+}
+
+template <ScenarioType S, typename Selection>
+void StaticGeneticAlgorithm<S, Selection>::appendOffspring(const Generation<T>& parents, std::size_t generation, float crossover_rate, std::vector<Member<GenomeHandle>>& next)
+{
+    GenomePool<T>& pool = *population_.pool();
+
+    // Mutation & Crossover
+    resizeBuffers(population_.populationSize() - next.size());
+    breed(parents, generation, crossover_rate, next.size(), offspring_, fitness_, known_);
+
+    // Evaluate
+    evaluate(offspring_, fitness_, known_);
+
+    /// Add to new generation
+    for (std::size_t i = 0; i < offspring_.size(); ++i)
+    {
+        next.emplace_back(fitness_[i], pool.insert(std::move(offspring_[i])));
+    }
+}
+
+template <ScenarioType S, typename Selection>
+void StaticGeneticAlgorithm<S, Selection>::resizeBuffers(std::size_t num_offspring)
+{
+    offspring_.resize(num_offspring);
+    fitness_.resize(num_offspring);
+    known_.resize(num_offspring);
+}
+
+template <ScenarioType S, typename Selection>
+void StaticGeneticAlgorithm<S, Selection>::evolveSteadyState()
+{
+    if (!working_)
+        working_.emplace(population_.current());
+
+    // Immigrants take the place of the least fit members
+    if (!immigrants_.empty())
+    {
+        if (immigrants_.size() > working_->size())
+            immigrants_.resize(working_->size());
+        working_->replaceWorst(immigrants_);
+        immigrants_.clear();
+    }
+
+    const std::size_t generation = population_.numGenerations();
+    GenomePool<T>& pool = *population_.pool();
+
+    resizeBuffers(offspring_per_step_);
+    next_.reserve(population_.populationSize());
+
+    for (std::size_t step = 0; step < steps_per_snapshot_; ++step)
+    {
+        breed(*working_, generation, crossover_rate_, step * offspring_per_step_, offspring_, fitness_, known_);
+        evaluate(offspring_, fitness_, known_);
+
+        next_.clear();
+        for (std::size_t i = 0; i < offspring_.size(); ++i)
+        {
+            next_.emplace_back(fitness_[i], pool.insert(std::move(offspring_[i])));
+        }
+        working_->replaceWorst(next_);
+    }
+
+    // The snapshot shares the working population's genomes
+    next_.clear();
+    for (std::size_t i = 0; i < working_->size(); ++i)
+    {
+        pool.retain(working_->entry(i).value);
+        next_.push_back(working_->entry(i));
+    }
+    population_.pushNext(next_);
+
+    // Snapshots are bred from the working population rather than from the previous snapshot
+    population_.checkpoint();
+}
+
+template <ScenarioType S, typename Selection>
+void StaticGeneticAlgorithm<S, Selection>::breed(const Generation<T>& parents, std::size_t generation, float crossover_rate, std::size_t first_slot, std::span<T> offspring, std::span<float> fitness, std::span<uint8_t> known)
+{
+    constexpr bool incremental = requires(T& genome, util::RNG& rng, MutationRecord& record)
+    {
+        scenario_.mutateRecorded(genome, rng, record);
+        scenario_.evaluateFitnessDelta(genome, 0.f, record);
+    };
+
+    // Select two parents for every child of the batch at once, from a stream of their own
+    selected_.resize(2 * offspring.size());
+    util::RNG selection_rng = slotRng(generation, SELECTION_STREAM | first_slot);
+    selection_function_(parents, selection_rng, std::span<uint32_t>(selected_));
+
+    forEachSlot(0, offspring.size(), [&](std::size_t i)
+    {
+        util::RNG rng = slotRng(generation, first_slot + i);
+        known[i] = false;
+
+        const uint32_t a = selected_[2 * i];
+        const T& parent_a = parents[a].value;
+
+        if (crossover_rate >= 1.f || rng.real(0.f, 1.f) < crossover_rate)
+        {
+            const T& parent_b = parents[selected_[2 * i + 1]].value;
+
+            // Crossover
+            offspring[i] = scenario_.crossover(parent_a, parent_b, rng);
+
+            // Mutate
+            scenario_.mutate(offspring[i], rng);
+            return;
+        }
+
+        // Mutate alone, deriving fitness from the parent's where possible
+        offspring[i] = parent_a;
+        if constexpr (incremental)
+        {
+            MutationRecord record;
+            if (scenario_.mutateRecorded(offspring[i], rng, record))
+            {
+                fitness[i] = scenario_.evaluateFitnessDelta(offspring[i], parents.fitness(a), record);
+                known[i] = true;
+            }
+        }
+        else
+        {
+            scenario_.mutate(offspring[i], rng);
+        }
+    });
+}
+
+template <ScenarioType S, typename Selection>
+void StaticGeneticAlgorithm<S, Selection>::setSteadyState(std::size_t offspring_per_step, std::size_t steps_per_snapshot)
+{
+    if (offspring_per_step == 0 || offspring_per_step > population_.populationSize())
+        throw std::invalid_argument("offspring_per_step must be in the interval [1, population size]");
+    if (steps_per_snapshot == 0)
+        throw std::invalid_argument("steps_per_snapshot must be greater than 0");
+    // Every offspring of a snapshot needs its own slot below SELECTION_STREAM
+    if (steps_per_snapshot > (SELECTION_STREAM - 1) / offspring_per_step)
+        throw std::invalid_argument("offspring_per_step * steps_per_snapshot must be less than 2^31");
+
+    offspring_per_step_ = offspring_per_step;
+    steps_per_snapshot_ = steps_per_snapshot;
+    working_.reset();
+}
+
+template <ScenarioType S, typename Selection>
+void StaticGeneticAlgorithm<S, Selection>::setGenerational()
+{
+    offspring_per_step_ = 0;
+    steps_per_snapshot_ = 1;
+    working_.reset();
+}
+
+template <ScenarioType S, typename Selection>
+void StaticGeneticAlgorithm<S, Selection>::setCrossoverRate(float crossover_rate)
+{
+    if (!(crossover_rate >= 0.f && crossover_rate <= 1.f))
+        throw std::invalid_argument("crossover_rate must be in the interval [0, 1]");
+
+    crossover_rate_ = crossover_rate;
+
+    // Generations bred from now on use the new rate
+    const std::size_t from = population_.numGenerations();
+    if (crossover_rates_.back().first == from)
+        crossover_rates_.back().second = crossover_rate;
+    else
+        crossover_rates_.emplace_back(from, crossover_rate);
+}
+
+template <ScenarioType S, typename Selection>
+float StaticGeneticAlgorithm<S, Selection>::crossoverRateAt(std::size_t generation) const
+{
+    auto it = std::upper_bound(crossover_rates_.begin(), crossover_rates_.end(), generation, [](std::size_t g, const auto& entry)
+    {
+        return g < entry.first;
+    });
+    return std::prev(it)->second;
+}
+
+template <ScenarioType S, typename Selection>
+float StaticGeneticAlgorithm<S, Selection>::getCrossoverRate() const
+{
+    return crossover_rate_;
+}
+
+template <ScenarioType S, typename Selection>
+void StaticGeneticAlgorithm<S, Selection>::setThreads(std::size_t num_threads)
+{
+    if (num_threads == 0)
+        throw std::invalid_argument("num_threads must be greater than 0");
+
+    if (num_threads == 1)
+        pool_.reset();
+    else if (num_threads != getThreads())
+        pool_ = std::make_unique<util::ThreadPool>(num_threads);
+}
+
+template <ScenarioType S, typename Selection>
+std::size_t StaticGeneticAlgorithm<S, Selection>::getThreads() const
+{
+    return pool_ ? pool_->size() : 1;
+}
+
+template <ScenarioType S, typename Selection>
+void StaticGeneticAlgorithm<S, Selection>::setRetention(Retention retention, std::size_t n)
+{
+    population_.setRetention(retention, n);
+}
+
+template <ScenarioType S, typename Selection>
+void StaticGeneticAlgorithm<S, Selection>::spillTo(const std::filesystem::path& path)
+{
+    population_.spillTo(path);
+}
+
+template <ScenarioType S, typename Selection>
+void StaticGeneticAlgorithm<S, Selection>::setFitnessCache(std::size_t capacity, CachePolicy policy)
+{
+    if (capacity == 0)
+        cache_.reset();
+    else
+        cache_ = std::make_unique<FitnessCache<T>>(capacity, policy);
+}
+
+template <ScenarioType S, typename Selection>
+const FitnessCache<typename S::Genome>* StaticGeneticAlgorithm<S, Selection>::getFitnessCache() const
+{
+    return cache_.get();
+}
+
+template <ScenarioType S, typename Selection>
+util::RNG StaticGeneticAlgorithm<S, Selection>::slotRng(std::size_t generation, std::size_t slot) const
+{
+    // Each slot of each generation draws from its own stream of the population id;
+    // the key is the generator's counter, so no two slots' streams overlap
+    return util::RNG(population_.id(), (static_cast<uint64_t>(generation) << 32) | slot);
+}
+
+template <ScenarioType S, typename Selection>
+void StaticGeneticAlgorithm<S, Selection>::evaluate(std::span<T> genomes, std::span<float> fitness, std::span<const uint8_t> known)
+{
+    if (!cache_ && std::find(known.begin(), known.end(), true) == known.end())
+    {
+        evaluateUncached(genomes, fitness);
+        return;
+    }
+
+    // Gather the genomes whose fitness is neither known nor cached at the front so they still form one batch
+    swaps_.clear();
+    std::size_t misses = 0;
+    for (std::size_t i = 0; i < genomes.size(); ++i)
+    {
+        if (!known.empty() && known[i])
+            continue;
+
+        if (cache_)
+        {
+            if (std::optional<float> cached = cache_->find(genomes[i]))
+            {
+                fitness[i] = cached.value();
+                continue;
+            }
+        }
+
+        if (i != misses)
+        {
+            std::swap(genomes[i], genomes[misses]);
+            std::swap(fitness[i], fitness[misses]);
+            swaps_.emplace_back(i, misses);
+        }
+        ++misses;
+    }
+
+    evaluateUncached(genomes.first(misses), fitness.first(misses));
+    if (cache_)
+    {
+        for (std::size_t i = 0; i < misses; ++i)
+            cache_->insert(genomes[i], fitness[i]);
+    }
+
+    // Restore slot order so that enabling the cache does not change results
+    for (auto it = swaps_.rbegin(); it != swaps_.rend(); ++it)
+    {
+        std::swap(genomes[it->first], genomes[it->second]);
+        std::swap(fitness[it->first], fitness[it->second]);
+    }
+}
+
+template <ScenarioType S, typename Selection>
+void StaticGeneticAlgorithm<S, Selection>::evaluateUncached(std::span<const T> genomes, std::span<float> fitness)
+{
+    if (genomes.empty())
+        return;
+
+    if (!pool_)
+    {
+        evaluateBatch(genomes, fitness);
+        return;
+    }
+
+    // One contiguous batch per thread
+    const std::size_t batch_size = (genomes.size() + pool_->size() - 1) / pool_->size();
+    const std::size_t num_batches = (genomes.size() + batch_size - 1) / batch_size;
+    pool_->parallelFor(num_batches, [&](std::size_t b)
+    {
+        std::size_t begin = b * batch_size;
+        std::size_t count = std::min(batch_size, genomes.size() - begin);
+        evaluateBatch(genomes.subspan(begin, count), fitness.subspan(begin, count));
+    });
+}
+
+template <ScenarioType S, typename Selection>
+void StaticGeneticAlgorithm<S, Selection>::evaluateBatch(std::span<const T> genomes, std::span<float> fitness)
+{
+    if constexpr (requires { scenario_.evaluateFitnessBatch(genomes, fitness); })
+    {
+        scenario_.evaluateFitnessBatch(genomes, fitness);
+    }
+    else
+    {
+        for (std::size_t i = 0; i < genomes.size(); ++i)
+            fitness[i] = scenario_.evaluateFitness(genomes[i]);
+    }
+}
+
+template <ScenarioType S, typename Selection>
+template <typename F>
+void StaticGeneticAlgorithm<S, Selection>::forEachSlot(std::size_t begin, std::size_t end, F&& fn)
+{
+    if (begin >= end)
+        return;
+
+    if (pool_)
+    {
+        pool_->parallelFor(end - begin, [&](std::size_t i) { fn(begin + i); });
+    }
+    else
+    {
+        for (std::size_t slot = begin; slot < end; ++slot)
+            fn(slot);
+    }
+}
+
+template <ScenarioType S, typename Selection>
+inline std::size_t StaticGeneticAlgorithm<S, Selection>::numElites()
+{
+    return population_.populationSize() * elitism_rate_;
+}
+
+template <ScenarioType S, typename Selection>
+const std::string& StaticGeneticAlgorithm<S, Selection>::getProblem() const
+{
+    return scenario_.getName();
+}
+
+template <ScenarioType S, typename Selection>
+const PopulationHistory<typename S::Genome>& StaticGeneticAlgorithm<S, Selection>::getPopulation() const
+{
+    return population_;
+}
+
+template <ScenarioType S, typename Selection>
+GenerationView<typename S::Genome> StaticGeneticAlgorithm<S, Selection>::generation(std::size_t i)
+{
+    if (population_.isRetained(i) || !population_.isReplayable(i))
+        return population_.generation(i);
+    if (replayed_ && replayed_index_ == i)
+        return *replayed_;
+
+    // Continue from the last replayed generation when no retained one lies between it and i
+    const std::vector<std::size_t>& retained = population_.retainedGenerations();
+    std::size_t from = *std::prev(std::lower_bound(retained.begin(), retained.end(), i));
+    std::optional<Generation<T>> parents;
+    if (replayed_ && replayed_index_ > from && replayed_index_ < i)
+    {
+        from = replayed_index_;
+        parents = std::move(replayed_);
+    }
+    replayed_.reset();
+
+    std::vector<Member<GenomeHandle>> next;
+    for (std::size_t g = from + 1; g <= i; ++g)
+    {
+        const Generation<T>& source = parents ? *parents : population_.retained(from);
+        next.clear();
+        next.reserve(population_.populationSize());
+        appendElites(source, next);
+        appendOffspring(source, g, crossoverRateAt(g), next);
+        parents.emplace(population_.pool(), std::move(next));
+    }
+
+    replayed_ = std::move(parents);
+    replayed_index_ = i;
+    return *replayed_;
+}
+
+template <ScenarioType S, typename Selection>
+const Serializer<typename S::Genome>& StaticGeneticAlgorithm<S, Selection>::getSerializer()
+{
+    return scenario_.getSerializer();
+}
+
+template <ScenarioType S, typename Selection>
+bool StaticGeneticAlgorithm<S, Selection>::savePopulation()
+{
+    return scenario_.getSerializer().save(population_);
+}
+
+template <ScenarioType S, typename Selection>
+bool StaticGeneticAlgorithm<S, Selection>::loadPopulation(std::string id)
+{
+    std::optional<PopulationHistory<T>> data = scenario_.getSerializer().load(id);
+
+    if (data.has_value())
+    { 
+        population_.load(std::move(data.value()));
+        working_.reset();
+        immigrants_.clear();
+        replayed_.reset();
+
+        // The rates the loaded generations were bred with are not saved
+        crossover_rates_.assign(1, {0, crossover_rate_});
+        return true;
+    }
+    return false;
+}
+
+template <ScenarioType S, typename Selection>
+std::vector<std::string> StaticGeneticAlgorithm<S, Selection>::getSaves() const
+{
+    return scenario_.getSerializer().getSaves();
+}
+
+template <ScenarioType S, typename Selection>
+bool StaticGeneticAlgorithm<S, Selection>::deleteSave(const std::string& id) const
+{
+    return scenario_.getSerializer().deleteSave(id);
+}
+
+template <ScenarioType S, typename Selection>
+bool StaticGeneticAlgorithm<S, Selection>::deleteAllSaves() const
+{
+    return scenario_.getSerializer().deleteAllSaves();
+}
+
+}
\ No newline at end of file
@@ -2,7 +2,9 @@
 #define BINARY_ENCODING_H
 
 #include "utils/rng.h"
-#include <bitset>
+#include <array>
+#include <cstdint>
+#include <cstddef>
 
 namespace genetic 
 {
@@ -11,15 +13,25 @@ template <typename T>
 class BinaryEncoding {
     static_assert(std::is_trivially_copyable_v<T> == true);
 
+    public:
+        static constexpr std::size_t BITS = sizeof(T)*8;
+        static constexpr std::size_t WORDS = (BITS + 63) / 64;
+        using Words = std::array<uint64_t, WORDS>;
+
     private:
-        std::bitset<sizeof(T)*8> data_;
+        // Bit i of the value is bit i % 64 of word i / 64; bits past the end
+        // of T stay zero, so that equal values have equal bytes
+        Words data_;
+
+        static constexpr uint64_t LAST_WORD_MASK = BITS % 64 == 0 ? ~uint64_t(0) : (uint64_t(1) << (BITS % 64)) - 1;
 
     public:
         BinaryEncoding();
         BinaryEncoding(T value);
         T get() const;
         void set(T value);
-        const std::bitset<sizeof(T)*8>& data() const;
+        const Words& data() const;
+        bool test(std::size_t bit) const;
 
         static BinaryEncoding birth(util::RNG& rng);
         static BinaryEncoding crossover(const BinaryEncoding& a, const BinaryEncoding& b, util::RNG& rng);
@@ -30,4 +42,4 @@ class BinaryEncoding {
 
 #include "binary_encoding.tpp"
 
-#endif
\ No newline at end of file
+#endif
@@ -1,4 +1,6 @@
 #include "binary_encoding.h"
+#include <cmath>
+#include <cstring>
 
 namespace genetic 
 {
@@ -10,46 +12,44 @@ BinaryEncoding<T>::BinaryEncoding()
 
 template <typename T>
 BinaryEncoding<T>::BinaryEncoding(T value)
-    : data_(value)
-{}
+    : data_()
+{
+    set(value);
+}
 
 template <typename T>
 T BinaryEncoding<T>::get() const
 {
     T result;
-    
-    // Convert bitset to bytes, write into result.
-    for (size_t i = 0; i < sizeof(T); ++i) {
-        unsigned char byte = 0;
-        for (size_t j = 0; j < 8; ++j) {
-            if (data_[i * 8 + j]) {
-                byte |= (1 << j);
-            }
-        }
-        reinterpret_cast<unsigned char*>(&result)[i] = byte;
-    }
-    
+    std::memcpy(&result, data_.data(), sizeof(T));
     return result;
 }
 
 template <typename T>
 void BinaryEncoding<T>::set(T value)
 {
-    data_ = std::bitset<sizeof(T)>(value);
+    data_ = {};
+    std::memcpy(data_.data(), &value, sizeof(T));
 }
 
 template <typename T>
-const std::bitset<sizeof(T)*8>& BinaryEncoding<T>::data() const
+const typename BinaryEncoding<T>::Words& BinaryEncoding<T>::data() const
 {
     return data_;
 }
 
+template <typename T>
+bool BinaryEncoding<T>::test(std::size_t bit) const
+{
+    return (data_[bit / 64] >> (bit % 64)) & 1;
+}
+
 template <typename T>
 BinaryEncoding<T> BinaryEncoding<T>::birth(util::RNG& rng)
 {
     BinaryEncoding<T> baby;
-    for (std::size_t i = 0; i < baby.data_.size(); ++i)
-        if(rng.integer(0,1)) baby.data_.flip(i);
+    rng.fillBits(baby.data_);
+    baby.data_[WORDS - 1] &= LAST_WORD_MASK;
     return baby;
 }
 
@@ -58,9 +58,16 @@ BinaryEncoding<T> BinaryEncoding<T>::crossover(const BinaryEncoding<T>& a, const
 {
     BinaryEncoding<T> offspring;
 
-    std::size_t crossover_point = rng.index(offspring.data_.size());
-    for (int i = 0; i < offspring.data_.size(); ++i)
-        offspring.data_.set(i, i < crossover_point ? a.data_[i] : b.data_[i]);
+    // Bits below the crossover point come from a, the rest from b
+    const std::size_t crossover_point = rng.index(BITS);
+    for (std::size_t w = 0; w < WORDS; ++w)
+    {
+        const std::size_t first_bit = w * 64;
+        const uint64_t from_a = crossover_point >= first_bit + 64 ? ~uint64_t(0)
+            : crossover_point <= first_bit ? 0
+            : (uint64_t(1) << (crossover_point - first_bit)) - 1;
+        offspring.data_[w] = (a.data_[w] & from_a) | (b.data_[w] & ~from_a);
+    }
 
     return offspring;
 }
@@ -70,10 +77,22 @@ template <int R>
 void BinaryEncoding<T>::mutate(BinaryEncoding& bin, util::RNG& rng)
 {
     static_assert(R >= 0 && R <= 100, "<R> must be in the interval [0, 100]");
+    if constexpr (R == 0)
+        return;
+
+    // Each bit flips with probability R / 101, as if it rolled integer(0, 100) < R.
+    // Rather than roll every bit, jump straight to the next flip: the gap before
+    // it is geometrically distributed, so the draws scale with the flips made.
+    static const double log_keep = std::log1p(-R / 101.0);
+    auto gap = [&]()
+    {
+        const double u = static_cast<double>((rng.bounded(0) >> 11) + 1) * 0x1.0p-53; // In (0, 1]
+        const double skipped = std::floor(std::log(u) / log_keep);
+        return skipped < static_cast<double>(BITS) ? static_cast<std::size_t>(skipped) : BITS;
+    };
 
-    for (int i = 0; i < bin.data_.size(); ++i)
-        if(rng.integer(0, 100) < R)
-            bin.data_.flip(i);
+    for (std::size_t bit = gap(); bit < BITS; bit += 1 + gap())
+        bin.data_[bit / 64] ^= uint64_t(1) << (bit % 64);
 }
 
-}
\ No newline at end of file
+}
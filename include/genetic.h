@@ -6,14 +6,26 @@
 #include "controller/graphic_view.h"
 #include "controller/view.h"
 #include "core/binary_scenario.h"
+#include "core/async_ga.h"
+#include "core/fitness_cache.h"
 #include "core/ga.h"
+#include "core/island_model.h"
 #include "core/member.h"
 #include "core/generation.h"
+#include "core/generation_stats.h"
+#include "core/generation_store.h"
+#include "core/generation_view.h"
+#include "core/genome_pool.h"
 #include "core/population_history.h"
 #include "core/scenario.h"
+#include "core/static_ga.h"
 #include "encoding/binary_encoding.h"
 #include "operator/selection.h"
 #include "serialization/serializer.h"
+#include "utils/alias_table.h"
+#include "utils/mailbox.h"
 #include "utils/rng.h"
+#include "utils/thread_pool.h"
+#include "utils/work_stealing_pool.h"
 
 #endif
\ No newline at end of file
@@ -2,30 +2,59 @@
 #define SELECTION_H
 
 #include "core/generation.h"
+#include "tournament_kernel.h"
 #include "utils/rng.h"
 #include <vector>
 #include <functional>
+#include <span>
+#include <cstdint>
 
 namespace genetic 
 {
 
 namespace selection
 {
+// Fills `selected` with the indices of the members chosen to breed, all at
+// once, so that a scheme can work across the whole batch
 template <typename T>
-using Function = std::function<const T&(const Generation<T>&, util::RNG& rng)>;
+using Function = std::function<void(const Generation<T>&, util::RNG& rng, std::span<uint32_t> selected)>;
 
+// Stateless callable wrapping a selection function known at compile time,
+// e.g. Static<tournament<T, 5>>, so that StaticGeneticAlgorithm can inline it
+template <auto F>
+struct Static
+{
+    template <typename T>
+    void operator()(const Generation<T>& generation, util::RNG& rng, std::span<uint32_t> selected) const
+    {
+        F(generation, rng, selected);
+    }
+};
+
+// Best of N members drawn at random, deciding the whole batch in SIMD lanes
+// where available; the winners do not depend on the instruction set
 template<typename T, std::size_t N>
-const T& tournament(const Generation<T>& generation, util::RNG& rng);
+void tournament(const Generation<T>& generation, util::RNG& rng, std::span<uint32_t> selected);
+
+template<typename T>
+void rankBased(const Generation<T>& generation, util::RNG& rng, std::span<uint32_t> selected);
 
 template<typename T>
-const T& rankBased(const Generation<T>& generation, util::RNG& rng);
+void roulette(const Generation<T>& generation, util::RNG& rng, std::span<uint32_t> selected);
 
+// Stochastic universal sampling: fitness proportionate like roulette, but the
+// whole batch is placed by one spin with evenly spaced pointers, so each
+// member is chosen within one of its expected number of times
 template<typename T>
-const T& roulette(const Generation<T>& generation, util::RNG& rng);
+void stochasticUniversal(const Generation<T>& generation, util::RNG& rng, std::span<uint32_t> selected);
+
+// Chooses uniformly among the fittest Percent percent of the generation
+template<typename T, std::size_t Percent>
+void truncation(const Generation<T>& generation, util::RNG& rng, std::span<uint32_t> selected);
 
 }
 
 }
 
 #include "selection.tpp"
-#endif
\ No newline at end of file
+#endif
@@ -1,57 +1,116 @@
 #include "selection.h"
 #include <utility>
 #include <stdexcept>
+#include <algorithm>
+#include <cmath>
 
 namespace genetic 
 {
 
 template<typename T, std::size_t N>
-const T& selection::tournament(const Generation<T>& generation, util::RNG& rng)
+void selection::tournament(const Generation<T>& generation, util::RNG& rng, std::span<uint32_t> selected)
 {
-    int i = rng.index(generation.size());
+    static_assert(N > 0, "A tournament needs at least one entrant");
 
-    int fittest_i = i;
-    
-    for (int k = 1; k < N; ++k)
+    // Candidates are drawn in the same order as one tournament at a time would draw them,
+    // then every tournament of the batch is decided together in vector lanes
+    thread_local std::vector<uint32_t> candidates;
+    candidates.resize(kernel::candidateCount(selected.size(), N));
+    for (std::size_t i = 0; i < selected.size(); ++i)
     {
-        int j = rng.index(generation.size());
-        if (generation[j].fitness > generation[fittest_i].fitness)
-            fittest_i = j;
+        for (std::size_t k = 0; k < N; ++k)
+        {
+            candidates[kernel::candidateSlot(i, k, N)] = static_cast<uint32_t>(rng.index(generation.size()));
+        }
     }
 
-    return generation[fittest_i].value;
+    kernel::winners(generation.fitness().data(), candidates.data(), N, selected);
 }
 
 template<typename T>
-const T& selection::rankBased(const Generation<T>& generation, util::RNG& rng)
+void selection::rankBased(const Generation<T>& generation, util::RNG& rng, std::span<uint32_t> selected)
 {
-    auto size = generation.size();
-    int total_rank = size*(size+1)/2;
+    // Rank i (0 being the least fit) is chosen with weight i + 1
+    const long int size = generation.size();
+    const long int total_rank = size*(size+1)/2;
 
-    int spin = rng.integer(1, total_rank);
-    int i = 0;
-    while(spin > i + 1)
+    for (uint32_t& choice : selected)
     {
-        spin -= (i + 1);
-        ++i;
+        // The lowest rank whose cumulative weight (i + 1)(i + 2) / 2 reaches the spin
+        const long int spin = rng.integer(1, total_rank);
+        long int i = static_cast<long int>(std::ceil((std::sqrt(8.0 * spin + 1.0) - 1.0) / 2.0)) - 1;
+        i = std::clamp(i, 0L, size - 1);
+        while (i > 0 && i*(i+1)/2 >= spin)
+            --i;
+        while ((i+1)*(i+2)/2 < spin)
+            ++i;
+
+        choice = generation.indexOfRank(i);
     }
-    return generation[i].value;
 }
 
 template<typename T>
-const T& selection::roulette(const Generation<T>& generation, util::RNG& rng)
+void selection::roulette(const Generation<T>& generation, util::RNG& rng, std::span<uint32_t> selected)
 {
     if (generation.lowestScore() < 0.f)
         throw std::invalid_argument("Generation cannot have negative fitness scores");
 
-    int spin = rng.real(0.f, generation.totalFitness());
-    int i = 0;
-    while(spin > generation[i].fitness)
+    // The generation builds its alias table once, after which each pick takes constant time
+    const util::AliasTable& table = generation.fitnessTable();
+    for (uint32_t& choice : selected)
+    {
+        choice = static_cast<uint32_t>(table.sample(rng));
+    }
+}
+
+template<typename T>
+void selection::stochasticUniversal(const Generation<T>& generation, util::RNG& rng, std::span<uint32_t> selected)
+{
+    if (generation.lowestScore() < 0.f)
+        throw std::invalid_argument("Generation cannot have negative fitness scores");
+    if (selected.empty())
+        return;
+
+    const std::size_t size = generation.size();
+    const double total = generation.totalFitness();
+    if (total <= 0.0)
+    {
+        for (uint32_t& choice : selected)
+            choice = static_cast<uint32_t>(rng.index(size));
+        return;
+    }
+
+    // Pointers and cumulative fitness both only increase, so one walk places them all
+    const double spacing = total / selected.size();
+    const double start = rng.real(0.f, 1.f) * spacing;
+    std::size_t i = 0;
+    double cumulative = generation.fitness(0);
+    for (std::size_t k = 0; k < selected.size(); ++k)
     {
-        spin -= generation[i].fitness;
-        ++i;
+        const double pointer = start + k * spacing;
+        while (cumulative <= pointer && i + 1 < size)
+            cumulative += generation.fitness(++i);
+        selected[k] = static_cast<uint32_t>(i);
     }
-    return generation[i].value;
+
+    // The walk leaves choices in storage order; shuffle them so that mates are not neighbours
+    for (std::size_t k = selected.size() - 1; k > 0; --k)
+        std::swap(selected[k], selected[rng.index(k + 1)]);
 }
 
-}
\ No newline at end of file
+template<typename T, std::size_t Percent>
+void selection::truncation(const Generation<T>& generation, util::RNG& rng, std::span<uint32_t> selected)
+{
+    static_assert(Percent > 0 && Percent <= 100, "Truncation must keep between 1 and 100 percent");
+
+    const std::size_t size = generation.size();
+    const std::size_t kept = std::max<std::size_t>(1, size * Percent / 100);
+
+    // Ranks are sorted once per generation and shared by every batch
+    for (uint32_t& choice : selected)
+    {
+        choice = generation.indexOfRank(size - 1 - rng.index(kept));
+    }
+}
+
+}
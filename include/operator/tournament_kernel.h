@@ -0,0 +1,95 @@
+#ifndef TOURNAMENT_KERNEL_H
+#define TOURNAMENT_KERNEL_H
+
+#include <span>
+#include <cstdint>
+#include <cstddef>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define GENETIC_TOURNAMENT_AVX2
+#endif
+
+namespace genetic
+{
+
+namespace selection::kernel
+{
+// Tournaments are decided in blocks of LANES, one per vector lane. Candidates
+// are laid out block by block, and within a block round by round: candidate k
+// of tournament i is at (i / LANES) * LANES * rounds + k * LANES + i % LANES.
+constexpr std::size_t LANES = 8;
+
+inline std::size_t candidateSlot(std::size_t tournament, std::size_t round, std::size_t rounds)
+{
+    return (tournament / LANES) * LANES * rounds + round * LANES + tournament % LANES;
+}
+
+// Buffer size for the given number of tournaments, rounded up to whole blocks
+inline std::size_t candidateCount(std::size_t tournaments, std::size_t rounds)
+{
+    return (tournaments + LANES - 1) / LANES * LANES * rounds;
+}
+
+// Each winner is the first candidate of strictly greatest fitness, as in the scalar loop
+inline void winnersScalar(const float* fitness, const uint32_t* candidates, std::size_t rounds, std::size_t first, std::span<uint32_t> winners)
+{
+    for (std::size_t i = first; i < winners.size(); ++i)
+    {
+        uint32_t best = candidates[candidateSlot(i, 0, rounds)];
+        for (std::size_t k = 1; k < rounds; ++k)
+        {
+            const uint32_t j = candidates[candidateSlot(i, k, rounds)];
+            if (fitness[j] > fitness[best])
+                best = j;
+        }
+        winners[i] = best;
+    }
+}
+
+#ifdef GENETIC_TOURNAMENT_AVX2
+// Whole blocks gather their candidates' fitness eight at a time; returns the
+// number of tournaments decided, leaving any partial block to the scalar loop
+__attribute__((target("avx2")))
+inline std::size_t winnersAvx2(const float* fitness, const uint32_t* candidates, std::size_t rounds, std::span<uint32_t> winners)
+{
+    const std::size_t blocks = winners.size() / LANES;
+    for (std::size_t b = 0; b < blocks; ++b)
+    {
+        const uint32_t* block = candidates + b * LANES * rounds;
+        __m256i best = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block));
+        __m256 best_fitness = _mm256_i32gather_ps(fitness, best, sizeof(float));
+
+        for (std::size_t k = 1; k < rounds; ++k)
+        {
+            const __m256i challenger = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + k * LANES));
+            const __m256 challenger_fitness = _mm256_i32gather_ps(fitness, challenger, sizeof(float));
+            const __m256 wins = _mm256_cmp_ps(challenger_fitness, best_fitness, _CMP_GT_OQ);
+            best_fitness = _mm256_blendv_ps(best_fitness, challenger_fitness, wins);
+            best = _mm256_blendv_epi8(best, challenger, _mm256_castps_si256(wins));
+        }
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(winners.data() + b * LANES), best);
+    }
+    return blocks * LANES;
+}
+#endif
+
+// Decides every tournament, in vector lanes where the processor supports it.
+// Both paths choose the same winners.
+inline void winners(const float* fitness, const uint32_t* candidates, std::size_t rounds, std::span<uint32_t> winners)
+{
+    std::size_t decided = 0;
+#ifdef GENETIC_TOURNAMENT_AVX2
+    static const bool avx2 = __builtin_cpu_supports("avx2");
+    if (avx2)
+        decided = winnersAvx2(fitness, candidates, rounds, winners);
+#endif
+    winnersScalar(fitness, candidates, rounds, decided, winners);
+}
+
+}
+
+}
+
+#endif
@@ -21,14 +21,23 @@ class Serializer
 
     private:
         static constexpr std::size_t ID_STRING_SIZE = sizeof(uint32_t)*2;
+        // Set in the generation count of histories that did not retain every generation
+        static constexpr std::size_t SPARSE_HISTORY = std::size_t(1) << 63;
+        // Set in the generation count of delta-encoded histories
+        static constexpr std::size_t DELTA_HISTORY = std::size_t(1) << 62;
+        static constexpr uint32_t NEW_MEMBER = UINT32_MAX;
         const std::string save_directory_;
+        const std::size_t keyframe_interval_;
         
         std::string formatFilename(uint32_t id, std::size_t generation, float fitness) const;
         std::optional<std::filesystem::path> findPopulationFile(const std::string& id) const;
         std::optional<std::filesystem::path> findPopulationFile(uint32_t id) const;
         
     public:
-        Serializer(std::string problem_name);
+        // Every keyframe_interval-th generation saved is stored whole, and those in
+        // between as references to identical members of the previous one plus
+        // their new members. A keyframe interval of 0 stores every generation whole.
+        Serializer(std::string problem_name, std::size_t keyframe_interval = 16);
 
         bool save(PopulationHistory<T>& pop) const;
         std::optional<PopulationHistory<T>> load(const std::string& id) const;
@@ -3,13 +3,18 @@
 #include <format>
 #include <iostream>
 #include <fstream>
+#include <unordered_map>
+#include <algorithm>
+#include "core/generation.h"
+#include "utils/hash.h"
 
 namespace genetic 
 {
 
 template <typename T>
-Serializer<T>::Serializer(std::string problem_name):
-    save_directory_("populations/"+problem_name+"/")
+Serializer<T>::Serializer(std::string problem_name, std::size_t keyframe_interval):
+    save_directory_("populations/"+problem_name+"/"),
+    keyframe_interval_(keyframe_interval)
 {}
 
 template <typename T>
@@ -103,23 +108,108 @@ bool Serializer<T>::save(PopulationHistory<T>& pop) const
     }
 
     // Number of Generations
-    std::size_t num_gens = pop.generations_.size();
-    output.write(reinterpret_cast<char*>(&num_gens), sizeof(std::size_t));
+    std::size_t num_gens = pop.num_generations_;
+    const bool sparse = pop.generations_.size() != num_gens;
+    const bool delta = keyframe_interval_ > 0;
+    std::size_t tagged_num_gens = num_gens | (sparse ? SPARSE_HISTORY : 0) | (delta ? DELTA_HISTORY : 0);
+    output.write(reinterpret_cast<char*>(&tagged_num_gens), sizeof(std::size_t));
     if (!output.good())
     {
         std::cerr << "Failed to write number of generations\n";
         return false;
     }
-    
-        
-    // Generations
-    for (int i = 0; i < num_gens; ++i)
+
+    auto write = [&output](const void* data, std::size_t bytes, const std::string& what)
     {
-        output.write(reinterpret_cast<char*>(pop.generations_[i].members_.data()), sizeof(Member<T>)*pop.population_size_);
+        output.write(reinterpret_cast<const char*>(data), bytes);
         if (!output.good())
-        {
-            std::cerr << "Failed to write generation " << (i + 1) << "\n";
+            std::cerr << "Failed to write " << what << "\n";
+        return output.good();
+    };
+
+    uint32_t keyframe_interval = static_cast<uint32_t>(keyframe_interval_);
+    if (delta && !write(&keyframe_interval, sizeof(uint32_t), "keyframe interval"))
+        return false;
+
+    // A sparse history keeps every generation's statistics and fittest member, then the generations it retained
+    if (sparse)
+    {
+        std::size_t num_fittest = pop.fittest_genomes_.size();
+        std::size_t num_retained = pop.generations_.size();
+        if (!write(pop.stats_.data(), sizeof(GenerationStats)*num_gens, "generation statistics")
+            || !write(&num_fittest, sizeof(std::size_t), "number of fittest genomes")
+            || !write(pop.fittest_genomes_.data(), sizeof(T)*num_fittest, "fittest genomes")
+            || !write(pop.fittest_indices_.data(), sizeof(uint32_t)*num_gens, "fittest history")
+            || !write(&num_retained, sizeof(std::size_t), "number of retained generations"))
+            return false;
+    }
+
+    // Generations. Between keyframes, members identical to one of the previous
+    // generation's are stored as its index, followed by only the new members.
+    std::vector<Member<T>> previous;
+    std::unordered_multimap<uint64_t, uint32_t> previous_lookup;
+    std::vector<uint32_t> sources (pop.population_size_);
+    std::vector<Member<T>> fresh;
+    for (std::size_t i = 0; i < pop.generations_.size(); ++i)
+    {
+        if (sparse && !write(&pop.indices_[i], sizeof(std::size_t), "index of generation " + std::to_string(pop.indices_[i])))
             return false;
+
+        const std::string what = "generation " + std::to_string(pop.indices_[i] + 1);
+        // In the order the generation holds them, so that reloading reproduces it exactly
+        const Generation<T>& generation = pop.generations_[i];
+        std::vector<Member<T>> members;
+        members.reserve(generation.size());
+        for (std::size_t j = 0; j < generation.size(); ++j)
+            members.push_back(generation[j]);
+        if (!delta || i % keyframe_interval_ == 0)
+        {
+            if (!write(members.data(), sizeof(Member<T>)*pop.population_size_, what))
+                return false;
+        }
+        else
+        {
+            fresh.clear();
+            for (std::size_t j = 0; j < members.size(); ++j)
+            {
+                sources[j] = NEW_MEMBER;
+                auto [begin, end] = previous_lookup.equal_range(util::hashBytes(members[j].value));
+                for (auto it = begin; it != end; ++it)
+                {
+                    const Member<T>& candidate = previous[it->second];
+                    if (candidate.fitness == members[j].fitness && util::equalBytes(candidate.value, members[j].value))
+                    {
+                        sources[j] = it->second;
+                        break;
+                    }
+                }
+                if (sources[j] == NEW_MEMBER)
+                    fresh.push_back(members[j]);
+            }
+
+            // When too few members are shared to pay for the references, store it whole,
+            // which is marked by every member being new
+            uint32_t num_new = static_cast<uint32_t>(fresh.size());
+            const std::size_t num_shared = pop.population_size_ - num_new;
+            if (num_shared*sizeof(Member<T>) <= sizeof(uint32_t)*pop.population_size_)
+            {
+                num_new = pop.population_size_;
+                if (!write(&num_new, sizeof(uint32_t), what)
+                    || !write(members.data(), sizeof(Member<T>)*pop.population_size_, what))
+                    return false;
+            }
+            else if (!write(&num_new, sizeof(uint32_t), what)
+                || !write(sources.data(), sizeof(uint32_t)*pop.population_size_, what)
+                || !write(fresh.data(), sizeof(Member<T>)*num_new, what))
+                return false;
+        }
+
+        if (delta)
+        {
+            previous = std::move(members);
+            previous_lookup.clear();
+            for (std::size_t j = 0; j < previous.size(); ++j)
+                previous_lookup.emplace(util::hashBytes(previous[j].value), static_cast<uint32_t>(j));
         }
     }
 
@@ -184,19 +274,130 @@ std::optional<PopulationHistory<T>> Serializer<T>::load(const std::string& id) c
         std::cerr << "Failed to read number of generations\n";
         return std::nullopt;
     }
-        
-    // Generations
-    for (int i = 0; i < num_gens; ++i)
+    const bool sparse = num_gens & SPARSE_HISTORY;
+    const bool delta = num_gens & DELTA_HISTORY;
+    num_gens &= ~(SPARSE_HISTORY | DELTA_HISTORY);
+
+    auto read = [&input](void* data, std::size_t bytes, const std::string& what)
     {
-        std::vector<Member<T>> next;
-        next.resize(pop.population_size_);
-        input.read(reinterpret_cast<char*>(next.data()), sizeof(Member<T>)*pop.population_size_);
+        input.read(reinterpret_cast<char*>(data), bytes);
         if (!input.good())
+            std::cerr << "Failed to read " << what << "\n";
+        return input.good();
+    };
+    auto corrupt = [&path](const std::string& problem)
+    {
+        std::cerr << "File \"" << path.value().string() << "\" " << problem << "\n";
+        return std::nullopt;
+    };
+
+    uint32_t keyframe_interval = 0;
+    if (delta)
+    {
+        if (!read(&keyframe_interval, sizeof(uint32_t), "keyframe interval"))
+            return std::nullopt;
+        if (keyframe_interval == 0)
+            return corrupt("has a keyframe interval of 0");
+    }
+
+    // Summaries, fittest members and the number of generations stored
+    std::size_t num_retained = num_gens;
+    if (sparse)
+    {
+        std::size_t num_fittest;
+        pop.stats_.resize(num_gens);
+        pop.fittest_indices_.resize(num_gens);
+        if (!read(pop.stats_.data(), sizeof(GenerationStats)*num_gens, "generation statistics")
+            || !read(&num_fittest, sizeof(std::size_t), "number of fittest genomes"))
+            return std::nullopt;
+
+        pop.fittest_genomes_.resize(num_fittest);
+        if (!read(pop.fittest_genomes_.data(), sizeof(T)*num_fittest, "fittest genomes")
+            || !read(pop.fittest_indices_.data(), sizeof(uint32_t)*num_gens, "fittest history")
+            || !read(&num_retained, sizeof(std::size_t), "number of retained generations"))
+            return std::nullopt;
+
+        for (uint32_t fittest_index : pop.fittest_indices_)
         {
-            std::cerr << "Failed to read generation " << (i + 1) << "\n";
+            if (fittest_index != PopulationHistory<T>::NOT_RECORDED && fittest_index >= num_fittest)
+                return corrupt("has a corrupt fittest history");
+        }
+    }
+
+    // Generations. Members are inserted into the pool in file order, so that
+    // members referenced by the next generation share their genome with it.
+    GenomePool<T>& genome_pool = *pop.pool_;
+    std::vector<Member<GenomeHandle>> previous;
+    std::vector<Member<GenomeHandle>> entries;
+    std::vector<Member<T>> members (pop.population_size_);
+    std::vector<uint32_t> sources (pop.population_size_);
+    for (std::size_t i = 0; i < num_retained; ++i)
+    {
+        std::size_t index = i;
+        if (sparse && !read(&index, sizeof(std::size_t), "index of retained generation " + std::to_string(i + 1)))
             return std::nullopt;
+
+        const std::string what = "generation " + std::to_string(index + 1);
+        entries.clear();
+        if (!delta || i % keyframe_interval == 0)
+        {
+            if (!read(members.data(), sizeof(Member<T>)*pop.population_size_, what))
+                return std::nullopt;
+            for (Member<T>& member : members)
+                entries.emplace_back(member.fitness, genome_pool.insert(std::move(member.value)));
+        }
+        else
+        {
+            uint32_t num_new;
+            if (!read(&num_new, sizeof(uint32_t), what))
+                return std::nullopt;
+            if (num_new > pop.population_size_)
+                return corrupt("has more new members than its population size in " + what);
+            if (num_new == pop.population_size_)
+                std::fill(sources.begin(), sources.end(), NEW_MEMBER);
+            else if (!read(sources.data(), sizeof(uint32_t)*pop.population_size_, what))
+                return std::nullopt;
+            if (!read(members.data(), sizeof(Member<T>)*num_new, what))
+                return std::nullopt;
+
+            std::size_t next_new = 0;
+            for (uint32_t source : sources)
+            {
+                if (source == NEW_MEMBER)
+                {
+                    if (next_new == num_new)
+                        return corrupt("references too few new members in " + what);
+                    Member<T>& member = members[next_new++];
+                    entries.emplace_back(member.fitness, genome_pool.insert(std::move(member.value)));
+                }
+                else
+                {
+                    if (source >= previous.size())
+                        return corrupt("references a member that does not exist in " + what);
+                    genome_pool.retain(previous[source].value);
+                    entries.push_back(previous[source]);
+                }
+            }
         }
-        pop.pushNext(std::move(next));
+        previous = entries;
+
+        if (!sparse)
+        {
+            pop.pushNext(Generation<T>(pop.pool_, std::move(entries)));
+            continue;
+        }
+
+        if (index >= num_gens || (!pop.indices_.empty() && index <= pop.indices_.back()))
+            return corrupt("has retained generations out of order");
+        pop.generations_.emplace_back(pop.pool_, std::move(entries));
+        pop.indices_.push_back(index);
+    }
+
+    if (sparse)
+    {
+        if (pop.indices_.empty() || pop.indices_.back() != num_gens - 1)
+            return corrupt("does not hold its current generation");
+        pop.num_generations_ = num_gens;
     }
 
     input.close();
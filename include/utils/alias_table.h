@@ -0,0 +1,101 @@
+#ifndef ALIAS_TABLE_H
+#define ALIAS_TABLE_H
+
+#include "rng.h"
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+namespace util
+{
+
+// Samples indices in proportion to non-negative weights in constant time,
+// after building a table in linear time (Vose's alias method)
+class AliasTable
+{
+    private:
+        std::vector<float> probability_;
+        std::vector<uint32_t> alias_;
+
+        // Kept between builds, so that rebuilding allocates nothing once grown
+        std::vector<double> scaled_;
+        std::vector<uint32_t> small_;
+        std::vector<uint32_t> large_;
+
+    public:
+        void build(std::span<const float> weights)
+        {
+            const std::size_t n = weights.size();
+            if (n == 0)
+                throw std::invalid_argument("Cannot build an alias table over no weights");
+
+            double total = 0.0;
+            for (float weight : weights)
+            {
+                if (weight < 0.f)
+                    throw std::invalid_argument("Alias table weights cannot be negative");
+                total += weight;
+            }
+
+            probability_.resize(n);
+            alias_.resize(n);
+            scaled_.resize(n);
+            small_.clear();
+            large_.clear();
+
+            // Scale so that the average weight is 1; all zero weights sample uniformly
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                scaled_[i] = total > 0.0 ? weights[i] * n / total : 1.0;
+                (scaled_[i] < 1.0 ? small_ : large_).push_back(static_cast<uint32_t>(i));
+            }
+
+            // Pair each underfull column with an overfull one that tops it up
+            while (!small_.empty() && !large_.empty())
+            {
+                const uint32_t s = small_.back();
+                const uint32_t l = large_.back();
+                small_.pop_back();
+                large_.pop_back();
+
+                probability_[s] = static_cast<float>(scaled_[s]);
+                alias_[s] = l;
+                scaled_[l] = (scaled_[l] + scaled_[s]) - 1.0;
+                (scaled_[l] < 1.0 ? small_ : large_).push_back(l);
+            }
+
+            // Whatever remains is full, up to rounding error
+            for (uint32_t i : large_)
+            {
+                probability_[i] = 1.f;
+                alias_[i] = i;
+            }
+            for (uint32_t i : small_)
+            {
+                probability_[i] = 1.f;
+                alias_[i] = i;
+            }
+        }
+
+        std::size_t sample(RNG& rng) const
+        {
+            const std::size_t column = rng.index(probability_.size());
+            return rng.real(0.f, 1.f) < probability_[column] ? column : alias_[column];
+        }
+
+        std::size_t size() const
+        {
+            return probability_.size();
+        }
+
+        std::size_t memoryUsage() const
+        {
+            return probability_.capacity() * sizeof(float) + alias_.capacity() * sizeof(uint32_t)
+                + scaled_.capacity() * sizeof(double) + (small_.capacity() + large_.capacity()) * sizeof(uint32_t);
+        }
+};
+
+}
+
+#endif
@@ -0,0 +1,48 @@
+#ifndef HASH_H
+#define HASH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace util
+{
+
+// Fast non-cryptographic hash of an object's bytes: multiply-xorshift over
+// 8-byte words, then the remaining tail bytes. Equal objects hash equally only
+// if they have no padding or their padding was copied along with them.
+template <typename T>
+uint64_t hashBytes(const T& object)
+{
+    static_assert(std::is_trivially_copyable_v<T>, "T must be trivially copyable to be hashed by its bytes");
+
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&object);
+    constexpr uint64_t MULTIPLIER = 0x9e3779b97f4a7c15ull;
+    uint64_t h = sizeof(T) * MULTIPLIER;
+
+    std::size_t i = 0;
+    for (; i + sizeof(uint64_t) <= sizeof(T); i += sizeof(uint64_t))
+    {
+        uint64_t word;
+        std::memcpy(&word, bytes + i, sizeof(uint64_t));
+        h = (h ^ word) * MULTIPLIER;
+        h ^= h >> 32;
+    }
+
+    uint64_t tail = 0;
+    std::memcpy(&tail, bytes + i, sizeof(T) - i);
+    h = (h ^ tail) * MULTIPLIER;
+    return h ^ (h >> 29);
+}
+
+template <typename T>
+bool equalBytes(const T& a, const T& b)
+{
+    static_assert(std::is_trivially_copyable_v<T>, "T must be trivially copyable to be compared by its bytes");
+    return std::memcmp(&a, &b, sizeof(T)) == 0;
+}
+
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,70 @@
+#ifndef MAILBOX_H
+#define MAILBOX_H
+
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+namespace util
+{
+
+// Lock-free multi-producer, single-consumer mailbox. Producers never wait on
+// each other or on the consumer, and the consumer takes every message at once.
+// A consumer with nothing else to do can sleep until a message is posted.
+template <typename M>
+class Mailbox
+{
+    private:
+        struct Node
+        {
+            M message;
+            Node* next;
+        };
+
+        std::atomic<Node*> head_;
+
+    public:
+        Mailbox(): head_(nullptr) {}
+
+        ~Mailbox()
+        {
+            collect();
+        }
+
+        Mailbox(const Mailbox&) = delete;
+        Mailbox& operator=(const Mailbox&) = delete;
+
+        void post(M message)
+        {
+            Node* node = new Node{std::move(message), head_.load(std::memory_order_relaxed)};
+            while (!head_.compare_exchange_weak(node->next, node, std::memory_order_release, std::memory_order_relaxed));
+            head_.notify_one();
+        }
+
+        // Block until the mailbox holds a message
+        void wait() const
+        {
+            head_.wait(nullptr, std::memory_order_acquire);
+        }
+
+        // Take all messages posted so far, oldest first
+        std::vector<M> collect()
+        {
+            Node* node = head_.exchange(nullptr, std::memory_order_acquire);
+
+            std::vector<M> messages;
+            while (node != nullptr)
+            {
+                messages.push_back(std::move(node->message));
+                Node* next = node->next;
+                delete node;
+                node = next;
+            }
+            std::reverse(messages.begin(), messages.end());
+            return messages;
+        }
+};
+
+}
+
+#endif
@@ -2,33 +2,433 @@
 #define RNG_H
 
 #include <stdexcept>
+#include <algorithm>
 #include <random>
+#include <limits>
+#include <span>
+#include <type_traits>
+#include <cstdint>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define UTIL_PHILOX_AVX2
+#endif
 
 namespace util
 {
 
-class RNG
+// xoshiro256++ (Blackman and Vigna): four words of state, a handful of
+// shifts and adds per output, and a period of 2^256 - 1
+class Xoshiro256PlusPlus
+{
+    private:
+        uint64_t state_[4];
+
+        static uint64_t rotl(uint64_t x, int k)
+        {
+            return (x << k) | (x >> (64 - k));
+        }
+
+        static uint64_t splitMix64(uint64_t& x)
+        {
+            uint64_t z = (x += 0x9e3779b97f4a7c15ull);
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+            return z ^ (z >> 31);
+        }
+
+    public:
+        using result_type = uint64_t;
+
+        explicit Xoshiro256PlusPlus(uint64_t seed = 0, uint64_t stream = 0)
+        {
+            this->seed(seed, stream);
+        }
+
+        // The state is expanded by SplitMix64 from a mix of both words, so that
+        // neighbouring seeds and streams start far apart
+        void seed(uint64_t seed, uint64_t stream = 0)
+        {
+            uint64_t x = seed;
+            uint64_t mixed = splitMix64(x);
+            x = stream;
+            x = mixed ^ splitMix64(x);
+            for (uint64_t& word : state_)
+                word = splitMix64(x);
+            if ((state_[0] | state_[1] | state_[2] | state_[3]) == 0)
+                state_[0] = 1;
+        }
+
+        static constexpr result_type min() { return 0; }
+        static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+        result_type operator()()
+        {
+            const uint64_t result = rotl(state_[0] + state_[3], 23) + state_[0];
+            const uint64_t t = state_[1] << 17;
+            state_[2] ^= state_[0];
+            state_[3] ^= state_[1];
+            state_[1] ^= state_[2];
+            state_[0] ^= state_[3];
+            state_[2] ^= t;
+            state_[3] = rotl(state_[3], 45);
+            return result;
+        }
+};
+
+// Philox4x32-10 (Salmon et al.): a counter-based generator, whose n-th block
+// of output is a keyed bijection of n alone. A (seed, stream) pair selects
+// the key and the upper counter words, so distinct streams never overlap and
+// any position of any stream can be reached without generating what precedes it.
+class Philox4x32
 {
     private:
-        std::mt19937 gen_;
+        // Blocks are generated eight at a time, one per AVX2 lane where the
+        // processor has it, or otherwise interleaved so that their
+        // multiplications overlap in the pipeline
+        static constexpr unsigned BATCH = 8;
+        static constexpr unsigned OUTPUTS = 2 * BATCH; // 64-bit outputs per batch
+
+        uint32_t key_[2];
+        uint64_t block_;  // Counter of the first block not yet generated
+        uint64_t stream_; // Upper counter words
+        uint64_t outputs_[OUTPUTS];
+        unsigned next_; // Index of the next unused output
+
+        // Writes two outputs for each of Blocks consecutive blocks from `first`
+        template <unsigned Blocks>
+        void generateBlocks(uint64_t first, uint64_t* out) const
+        {
+            uint32_t x[4][Blocks];
+            for (unsigned b = 0; b < Blocks; ++b)
+            {
+                const uint64_t counter = first + b;
+                x[0][b] = static_cast<uint32_t>(counter);
+                x[1][b] = static_cast<uint32_t>(counter >> 32);
+                x[2][b] = static_cast<uint32_t>(stream_);
+                x[3][b] = static_cast<uint32_t>(stream_ >> 32);
+            }
+
+            uint32_t k0 = key_[0], k1 = key_[1];
+            for (int round = 0; round < 10; ++round)
+            {
+                for (unsigned b = 0; b < Blocks; ++b)
+                {
+                    const uint64_t product0 = static_cast<uint64_t>(0xD2511F53u) * x[0][b];
+                    const uint64_t product1 = static_cast<uint64_t>(0xCD9E8D57u) * x[2][b];
+                    x[0][b] = static_cast<uint32_t>(product1 >> 32) ^ x[1][b] ^ k0;
+                    x[1][b] = static_cast<uint32_t>(product1);
+                    x[2][b] = static_cast<uint32_t>(product0 >> 32) ^ x[3][b] ^ k1;
+                    x[3][b] = static_cast<uint32_t>(product0);
+                }
+                k0 += 0x9E3779B9u;
+                k1 += 0xBB67AE85u;
+            }
+
+            for (unsigned b = 0; b < Blocks; ++b)
+            {
+                out[2 * b] = x[0][b] | (static_cast<uint64_t>(x[1][b]) << 32);
+                out[2 * b + 1] = x[2][b] | (static_cast<uint64_t>(x[3][b]) << 32);
+            }
+        }
+
+#ifdef UTIL_PHILOX_AVX2
+        // _mm256_mul_epu32 multiplies the even lanes only, so odd lanes take a second multiply
+        __attribute__((target("avx2")))
+        static void mulhilo(__m256i a, __m256i m, __m256i& hi, __m256i& lo)
+        {
+            const __m256i even = _mm256_mul_epu32(a, m);
+            const __m256i odd = _mm256_mul_epu32(_mm256_srli_epi64(a, 32), m);
+            lo = _mm256_blend_epi32(even, _mm256_slli_epi64(odd, 32), 0xAA);
+            hi = _mm256_blend_epi32(_mm256_srli_epi64(even, 32), odd, 0xAA);
+        }
+
+        // BATCH blocks from `first`, one per 32-bit lane, in the same layout as generateBlocks
+        __attribute__((target("avx2")))
+        void generateBlocksAvx2(uint64_t first, uint64_t* out) const
+        {
+            alignas(32) uint32_t low[8], high[8];
+            for (unsigned b = 0; b < BATCH; ++b)
+            {
+                low[b] = static_cast<uint32_t>(first + b);
+                high[b] = static_cast<uint32_t>((first + b) >> 32);
+            }
+            __m256i x0 = _mm256_load_si256(reinterpret_cast<const __m256i*>(low));
+            __m256i x1 = _mm256_load_si256(reinterpret_cast<const __m256i*>(high));
+            __m256i x2 = _mm256_set1_epi32(static_cast<int>(static_cast<uint32_t>(stream_)));
+            __m256i x3 = _mm256_set1_epi32(static_cast<int>(static_cast<uint32_t>(stream_ >> 32)));
+
+            const __m256i m0 = _mm256_set1_epi32(static_cast<int>(0xD2511F53u));
+            const __m256i m1 = _mm256_set1_epi32(static_cast<int>(0xCD9E8D57u));
+
+            uint32_t k0 = key_[0], k1 = key_[1];
+            for (int round = 0; round < 10; ++round)
+            {
+                __m256i hi0, lo0, hi1, lo1;
+                mulhilo(x0, m0, hi0, lo0);
+                mulhilo(x2, m1, hi1, lo1);
+                x0 = _mm256_xor_si256(_mm256_xor_si256(hi1, x1), _mm256_set1_epi32(static_cast<int>(k0)));
+                x1 = lo1;
+                x2 = _mm256_xor_si256(_mm256_xor_si256(hi0, x3), _mm256_set1_epi32(static_cast<int>(k1)));
+                x3 = lo0;
+                k0 += 0x9E3779B9u;
+                k1 += 0xBB67AE85u;
+            }
+
+            // Transpose the four words of each lane back into consecutive blocks
+            const __m256i t0 = _mm256_unpacklo_epi32(x0, x1);
+            const __m256i t1 = _mm256_unpackhi_epi32(x0, x1);
+            const __m256i t2 = _mm256_unpacklo_epi32(x2, x3);
+            const __m256i t3 = _mm256_unpackhi_epi32(x2, x3);
+            const __m256i u0 = _mm256_unpacklo_epi64(t0, t2);
+            const __m256i u1 = _mm256_unpackhi_epi64(t0, t2);
+            const __m256i u2 = _mm256_unpacklo_epi64(t1, t3);
+            const __m256i u3 = _mm256_unpackhi_epi64(t1, t3);
+            __m256i* words = reinterpret_cast<__m256i*>(out);
+            _mm256_storeu_si256(words, _mm256_permute2x128_si256(u0, u1, 0x20));
+            _mm256_storeu_si256(words + 1, _mm256_permute2x128_si256(u2, u3, 0x20));
+            _mm256_storeu_si256(words + 2, _mm256_permute2x128_si256(u0, u1, 0x31));
+            _mm256_storeu_si256(words + 3, _mm256_permute2x128_si256(u2, u3, 0x31));
+        }
+#endif
+
+        static bool hasAvx2()
+        {
+#ifdef UTIL_PHILOX_AVX2
+            static const bool avx2 = __builtin_cpu_supports("avx2");
+            return avx2;
+#else
+            return false;
+#endif
+        }
+
+        void generateBatch()
+        {
+#ifdef UTIL_PHILOX_AVX2
+            if (hasAvx2())
+                generateBlocksAvx2(block_, outputs_);
+            else
+#endif
+                generateBlocks<BATCH>(block_, outputs_);
+            block_ += BATCH;
+            next_ = 0;
+        }
+
+    public:
+        using result_type = uint64_t;
+
+        explicit Philox4x32(uint64_t seed = 0, uint64_t stream = 0)
+        {
+            this->seed(seed, stream);
+        }
+
+        void seed(uint64_t seed, uint64_t stream = 0)
+        {
+            key_[0] = static_cast<uint32_t>(seed);
+            key_[1] = static_cast<uint32_t>(seed >> 32);
+            stream_ = stream;
+            seek(0);
+        }
+
+        // Moves to the given output of the stream, in constant time
+        void seek(uint64_t position)
+        {
+            block_ = position / OUTPUTS * BATCH;
+            generateBatch();
+            next_ = position % OUTPUTS;
+        }
+
+        void discard(uint64_t n)
+        {
+            seek(2 * block_ - (OUTPUTS - next_) + n);
+        }
+
+        static constexpr result_type min() { return 0; }
+        static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+        result_type operator()()
+        {
+            if (next_ == OUTPUTS)
+                generateBatch();
+            return outputs_[next_++];
+        }
+
+        // The same outputs as as many calls, with whole batches generated
+        // directly into `words` rather than through the buffer
+        void generate(std::span<uint64_t> words)
+        {
+            std::size_t i = 0;
+            while (i < words.size() && next_ < OUTPUTS)
+                words[i++] = outputs_[next_++];
+
+            for (; words.size() - i >= OUTPUTS; i += OUTPUTS)
+            {
+#ifdef UTIL_PHILOX_AVX2
+                if (hasAvx2())
+                    generateBlocksAvx2(block_, words.data() + i);
+                else
+#endif
+                    generateBlocks<BATCH>(block_, words.data() + i);
+                block_ += BATCH;
+            }
+
+            for (; i < words.size(); ++i)
+                words[i] = (*this)();
+        }
+};
+
+// Uniform sampling over a 64-bit engine, without constructing a standard
+// distribution per call. Bounded integers use Lemire's multiply-shift method,
+// which needs a division only when a draw falls in the rare rejection zone.
+template <typename Engine>
+class BasicRNG
+{
+    static_assert(std::is_same_v<typename Engine::result_type, uint64_t>
+        && Engine::min() == 0 && Engine::max() == std::numeric_limits<uint64_t>::max(),
+        "BasicRNG needs an engine producing full 64-bit words");
+
+    private:
+        Engine gen_;
+
+        static constexpr std::size_t CHUNK = 64; // Words generated per run of a bulk draw
+
+        // Lemire's method on a word already drawn, drawing more only on rejection
+        uint64_t boundedFrom(uint64_t x, uint64_t range)
+        {
+            if (range == 0)
+                return x;
+
+            unsigned __int128 product = static_cast<unsigned __int128>(x) * range;
+            uint64_t low = static_cast<uint64_t>(product);
+            if (low < range)
+            {
+                const uint64_t threshold = -range % range;
+                while (low < threshold)
+                {
+                    x = gen_();
+                    product = static_cast<unsigned __int128>(x) * range;
+                    low = static_cast<uint64_t>(product);
+                }
+            }
+            return static_cast<uint64_t>(product >> 64);
+        }
+
+        long int offset(long int low, long int high, uint64_t word)
+        {
+            const uint64_t range = static_cast<uint64_t>(high) - static_cast<uint64_t>(low) + 1;
+            return static_cast<long int>(static_cast<uint64_t>(low) + boundedFrom(word, range));
+        }
+
+        // The top 24 bits of a word scaled into [0, 1), exact in a float
+        static float toUnit(uint64_t word)
+        {
+            return static_cast<float>(word >> 40) * 0x1.0p-24f;
+        }
+
+        // Fills `values` a chunk at a time from bulk words
+        template <typename V, typename Map>
+        void fillMapped(std::span<V> values, Map map)
+        {
+            uint64_t words[CHUNK];
+            for (std::size_t i = 0; i < values.size(); i += CHUNK)
+            {
+                const std::size_t count = std::min<std::size_t>(CHUNK, values.size() - i);
+                fillBits(std::span<uint64_t>(words, count));
+                for (std::size_t k = 0; k < count; ++k)
+                    values[i + k] = map(words[k]);
+            }
+        }
+
+        static uint64_t randomSeed()
+        {
+            std::random_device device;
+            return device() | (static_cast<uint64_t>(device()) << 32);
+        }
+
+        // Produces the same state as std::seed_seq over four words, without its heap allocation
+        struct StreamSeed
+        {
+            using result_type = uint32_t;
+            uint32_t words[4];
+
+            template <typename It>
+            void generate(It begin, It end) const
+            {
+                const std::size_t n = end - begin;
+                if (n == 0)
+                    return;
+
+                constexpr std::size_t s = 4;
+                std::fill(begin, end, 0x8b8b8b8bu);
+                const std::size_t t = (n >= 623) ? 11 : (n >= 68) ? 7 : (n >= 39) ? 5 : (n >= 7) ? 3 : (n - 1) / 2;
+                const std::size_t p = (n - t) / 2;
+                const std::size_t q = p + t;
+                const std::size_t m = std::max(s + 1, n);
+                auto mix = [](uint32_t x) { return x ^ (x >> 27); };
+
+                for (std::size_t k = 0; k < m; ++k)
+                {
+                    uint32_t r1 = 1664525u * mix(begin[k % n] ^ begin[(k + p) % n] ^ begin[(k + n - 1) % n]);
+                    uint32_t r2 = r1 + static_cast<uint32_t>(k == 0 ? s : k <= s ? k % n + words[k - 1] : k % n);
+                    begin[(k + p) % n] += r1;
+                    begin[(k + q) % n] += r2;
+                    begin[k % n] = r2;
+                }
+                for (std::size_t k = m; k < m + n; ++k)
+                {
+                    uint32_t r3 = 1566083941u * mix(begin[k % n] + begin[(k + p) % n] + begin[(k + n - 1) % n]);
+                    uint32_t r4 = r3 - static_cast<uint32_t>(k % n);
+                    begin[(k + p) % n] ^= r3;
+                    begin[(k + q) % n] ^= r4;
+                    begin[k % n] = r4;
+                }
+            }
+        };
         
     public:
-        RNG(): gen_(std::random_device()()) {}
-        RNG(int seed): gen_(seed) {}
+        BasicRNG(): BasicRNG(randomSeed(), 0) {}
+        BasicRNG(int seed): gen_(seed) {}
+
+        // Independent stream of a seed, e.g. one per offspring slot, so that
+        // results do not depend on which thread consumes which stream
+        BasicRNG(uint64_t seed, uint64_t stream)
+        {
+            if constexpr (std::is_constructible_v<Engine, uint64_t, uint64_t>)
+            {
+                gen_ = Engine(seed, stream);
+            }
+            else
+            {
+                StreamSeed seq {{
+                    static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32),
+                    static_cast<uint32_t>(stream), static_cast<uint32_t>(stream >> 32)
+                }};
+                gen_.seed(seq);
+            }
+        }
+
+        // Uniform in [0, range), or any word when range is 0, i.e. 2^64
+        uint64_t bounded(uint64_t range)
+        {
+            return boundedFrom(gen_(), range);
+        }
 
         long int integer(long int low, long int high)
         {
             if (low > high)
                 throw std::invalid_argument("low must be <= high");
 
-            std::uniform_int_distribution<long int> dist(low, high);
-            return dist(gen_);
+            return offset(low, high, gen_());
         }
 
         std::size_t index(std::size_t size)
         {
-            std::uniform_int_distribution<std::size_t> dist(0, size - 1);
-            return dist(gen_);
+            return static_cast<std::size_t>(bounded(size));
+        }
+
+        float unit()
+        {
+            return toUnit(gen_());
         }
 
         float real(float low, float high)
@@ -36,16 +436,75 @@ class RNG
             if (low > high)
                 throw std::invalid_argument("low must be <= high");
 
-            std::uniform_real_distribution<> dist(low, high);
-            return dist(gen_);
+            return low + unit() * (high - low);
+        }
+
+        // Bulk draws: the words for a whole span are generated in one run,
+        // which the engine may vectorize, and then mapped in a separate loop.
+        // They follow the same distributions as the scalar calls, though not
+        // necessarily the same values.
+        void fillBits(std::span<uint64_t> words)
+        {
+            if constexpr (requires { gen_.generate(words); })
+            {
+                gen_.generate(words);
+            }
+            else
+            {
+                for (uint64_t& word : words)
+                    word = gen_();
+            }
         }
 
-        std::mt19937& generator()
+        void fillIntegers(std::span<long int> values, long int low, long int high)
+        {
+            if (low > high)
+                throw std::invalid_argument("low must be <= high");
+
+            fillMapped(values, [&](uint64_t word) { return offset(low, high, word); });
+        }
+
+        void fillIndices(std::span<std::size_t> values, std::size_t size)
+        {
+            fillMapped(values, [&](uint64_t word) { return static_cast<std::size_t>(boundedFrom(word, size)); });
+        }
+
+        void fillReals(std::span<float> values, float low, float high)
+        {
+            if (low > high)
+                throw std::invalid_argument("low must be <= high");
+
+            fillMapped(values, [&](uint64_t word) { return low + toUnit(word) * (high - low); });
+        }
+
+        // Fisher-Yates shuffle, with the swap positions drawn in bulk
+        template <typename V>
+        void shuffle(std::span<V> values)
+        {
+            uint64_t words[CHUNK];
+            std::size_t i = values.size();
+            while (i > 1)
+            {
+                const std::size_t count = std::min<std::size_t>(CHUNK, i - 1);
+                fillBits(std::span<uint64_t>(words, count));
+                for (std::size_t k = 0; k < count; ++k, --i)
+                    std::swap(values[i - 1], values[boundedFrom(words[k], i)]);
+            }
+        }
+
+        Engine& generator()
         {
             return gen_;
         }
 };
 
+// Counter-based, so that every (seed, stream) key names a disjoint stream
+// whatever the thread, island or process drawing from it
+using RNG = BasicRNG<Philox4x32>;
+// Faster for a single sequential stream, but its streams are only hashed apart
+using FastRNG = BasicRNG<Xoshiro256PlusPlus>;
+using MersenneRNG = BasicRNG<std::mt19937_64>;
+
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,153 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace util
+{
+
+// Fixed set of worker threads that cooperatively run index-parallel loops.
+// The calling thread participates, so a pool of size N spawns N - 1 workers.
+class ThreadPool
+{
+    private:
+        using Job = std::function<void(std::size_t)>;
+
+        std::vector<std::thread> workers_;
+        std::mutex mutex_;
+        std::condition_variable wake_;
+        std::condition_variable done_;
+
+        const Job* job_;
+        std::size_t job_size_;
+        std::atomic<std::size_t> next_index_;
+        std::size_t epoch_;
+        std::size_t active_workers_;
+        std::exception_ptr error_;
+        bool stopping_;
+
+        // Claim and run indices of the current job until none remain
+        void drain()
+        {
+            std::size_t i;
+            while ((i = next_index_.fetch_add(1, std::memory_order_relaxed)) < job_size_)
+            {
+                try
+                {
+                    (*job_)(i);
+                }
+                catch (...)
+                {
+                    std::lock_guard<std::mutex> lock (mutex_);
+                    if (!error_)
+                        error_ = std::current_exception();
+                    next_index_.store(job_size_, std::memory_order_relaxed);
+                }
+            }
+        }
+
+        void work()
+        {
+            std::size_t seen_epoch = 0;
+            while (true)
+            {
+                {
+                    std::unique_lock<std::mutex> lock (mutex_);
+                    wake_.wait(lock, [&]{ return stopping_ || epoch_ != seen_epoch; });
+                    if (stopping_)
+                        return;
+                    seen_epoch = epoch_;
+                }
+
+                drain();
+
+                std::lock_guard<std::mutex> lock (mutex_);
+                if (--active_workers_ == 0)
+                    done_.notify_one();
+            }
+        }
+
+    public:
+        explicit ThreadPool(std::size_t num_threads)
+            : job_(nullptr)
+            , job_size_(0)
+            , next_index_(0)
+            , epoch_(0)
+            , active_workers_(0)
+            , stopping_(false)
+        {
+            for (std::size_t i = 1; i < num_threads; ++i)
+                workers_.emplace_back(&ThreadPool::work, this);
+        }
+
+        ~ThreadPool()
+        {
+            {
+                std::lock_guard<std::mutex> lock (mutex_);
+                stopping_ = true;
+            }
+            wake_.notify_all();
+            for (std::thread& worker : workers_)
+                worker.join();
+        }
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        std::size_t size() const
+        {
+            return workers_.size() + 1;
+        }
+
+        // Call fn(i) for every i in [0, n), blocking until all calls return.
+        // The first exception thrown by fn is rethrown on the calling thread.
+        void parallelFor(std::size_t n, const Job& fn)
+        {
+            if (workers_.empty() || n <= 1)
+            {
+                for (std::size_t i = 0; i < n; ++i)
+                    fn(i);
+                return;
+            }
+
+            {
+                std::lock_guard<std::mutex> lock (mutex_);
+                job_ = &fn;
+                job_size_ = n;
+                next_index_.store(0, std::memory_order_relaxed);
+                active_workers_ = workers_.size();
+                error_ = nullptr;
+                ++epoch_;
+            }
+            wake_.notify_all();
+
+            drain();
+
+            std::unique_lock<std::mutex> lock (mutex_);
+            done_.wait(lock, [&]{ return active_workers_ == 0; });
+            job_ = nullptr;
+
+            if (error_)
+                std::rethrow_exception(error_);
+        }
+
+        // Wraps fn by reference, so that a large closure is not copied to the heap
+        template <typename F>
+            requires (!std::is_same_v<std::remove_cvref_t<F>, Job>)
+        void parallelFor(std::size_t n, F&& fn)
+        {
+            parallelFor(n, Job(std::ref(fn)));
+        }
+};
+
+}
+
+#endif
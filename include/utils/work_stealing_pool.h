@@ -0,0 +1,151 @@
+#ifndef WORK_STEALING_POOL_H
+#define WORK_STEALING_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace util
+{
+
+// Pool of worker threads with one task deque each. A worker runs its own
+// newest task first and, once it runs dry, steals the oldest task of another
+// worker, so uneven task costs do not leave workers idle.
+class WorkStealingPool
+{
+    private:
+        using Task = std::function<void()>;
+
+        struct Queue
+        {
+            std::mutex mutex;
+            std::deque<Task> tasks;
+        };
+
+        std::vector<std::unique_ptr<Queue>> queues_;
+        std::vector<std::thread> workers_;
+
+        std::mutex sleep_mutex_;
+        std::condition_variable wake_;
+        std::atomic<std::size_t> pending_;
+        std::atomic<std::size_t> next_queue_;
+        bool stopping_;
+
+        // Identifies the pool and queue owned by the current thread, if it is a worker
+        inline static thread_local const WorkStealingPool* current_pool_ = nullptr;
+        inline static thread_local std::size_t current_queue_ = 0;
+
+        bool tryPop(std::size_t self, Task& task)
+        {
+            {
+                Queue& own = *queues_[self];
+                std::lock_guard<std::mutex> lock (own.mutex);
+                if (!own.tasks.empty())
+                {
+                    task = std::move(own.tasks.back());
+                    own.tasks.pop_back();
+                    return true;
+                }
+            }
+
+            for (std::size_t i = 1; i < queues_.size(); ++i)
+            {
+                Queue& victim = *queues_[(self + i) % queues_.size()];
+                std::lock_guard<std::mutex> lock (victim.mutex);
+                if (!victim.tasks.empty())
+                {
+                    task = std::move(victim.tasks.front());
+                    victim.tasks.pop_front();
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        void work(std::size_t self)
+        {
+            current_pool_ = this;
+            current_queue_ = self;
+
+            while (true)
+            {
+                Task task;
+                if (tryPop(self, task))
+                {
+                    pending_.fetch_sub(1, std::memory_order_relaxed);
+                    task();
+                    continue;
+                }
+
+                std::unique_lock<std::mutex> lock (sleep_mutex_);
+                wake_.wait(lock, [&]{ return stopping_ || pending_.load(std::memory_order_relaxed) > 0; });
+                if (stopping_ && pending_.load(std::memory_order_relaxed) == 0)
+                    return;
+            }
+        }
+
+    public:
+        explicit WorkStealingPool(std::size_t num_threads)
+            : pending_(0)
+            , next_queue_(0)
+            , stopping_(false)
+        {
+            if (num_threads == 0)
+                num_threads = 1;
+
+            for (std::size_t i = 0; i < num_threads; ++i)
+                queues_.push_back(std::make_unique<Queue>());
+            for (std::size_t i = 0; i < num_threads; ++i)
+                workers_.emplace_back(&WorkStealingPool::work, this, i);
+        }
+
+        // Runs every task already submitted before joining
+        ~WorkStealingPool()
+        {
+            {
+                std::lock_guard<std::mutex> lock (sleep_mutex_);
+                stopping_ = true;
+            }
+            wake_.notify_all();
+            for (std::thread& worker : workers_)
+                worker.join();
+        }
+
+        WorkStealingPool(const WorkStealingPool&) = delete;
+        WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+        std::size_t size() const
+        {
+            return workers_.size();
+        }
+
+        // Tasks submitted by a worker go to its own deque, others are spread round-robin
+        void submit(Task task)
+        {
+            std::size_t index = current_pool_ == this
+                ? current_queue_
+                : next_queue_.fetch_add(1, std::memory_order_relaxed) % queues_.size();
+
+            pending_.fetch_add(1, std::memory_order_relaxed);
+            {
+                Queue& queue = *queues_[index];
+                std::lock_guard<std::mutex> lock (queue.mutex);
+                queue.tasks.push_back(std::move(task));
+            }
+
+            {
+                std::lock_guard<std::mutex> lock (sleep_mutex_);
+            }
+            wake_.notify_one();
+        }
+};
+
+}
+
+#endif